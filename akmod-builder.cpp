@@ -0,0 +1,44 @@
+#include "akmod-builder.h"
+#include "work-stealing-pool.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+AkmodBuilder::AkmodBuilder(std::shared_ptr<CommandRunner> runner, AkmodBuildOptions options)
+    : runner(std::move(runner)), options(std::move(options)) {
+}
+
+std::vector<std::string> AkmodBuilder::installedKernels() const {
+    // Katalogi bez nagłówków to zwykle pozostałości po usuniętych jądrach (same moduły extra)
+    std::vector<std::string> kernels;
+    std::error_code error;
+    for (fs::directory_iterator it(options.modulesRoot, error), end; !error && it != end; it.increment(error)) {
+        std::error_code buildError;
+        if (it->is_directory(buildError) && fs::exists(it->path() / "build", buildError)) {
+            kernels.push_back(it->path().filename().string());
+        }
+    }
+    std::sort(kernels.begin(), kernels.end());
+    return kernels;
+}
+
+std::vector<KernelBuildResult> AkmodBuilder::build(const std::vector<std::string>& kernels) {
+    std::vector<KernelBuildResult> results(kernels.size());
+    WorkStealingPool pool(options.jobs);
+    pool.parallelFor(kernels.size(), [&](size_t index) {
+        KernelBuildResult& result = results[index];
+        result.kernel = kernels[index];
+        
+        auto start = std::chrono::steady_clock::now();
+        CommandResult command = runner->run({"akmods", "--force", "--kernels", kernels[index], "--akmod", options.akmod});
+        result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        result.success = command.success();
+        if (!result.success) {
+            result.errorOutput = command.errorOutput.empty() ? command.output : command.errorOutput;
+        }
+    });
+    return results;
+}
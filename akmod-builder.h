@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "command-runner.h"
+
+// Ustawienia budowania modułów akmods dla zainstalowanych jąder
+struct AkmodBuildOptions {
+    std::string akmod = "nvidia";               // Nazwa akmod (pakiet akmod-<nazwa>)
+    std::string modulesRoot = "/lib/modules";   // Katalog modułów jądra
+    size_t jobs = 1;                            // Liczba jąder budowanych jednocześnie
+};
+
+// Wynik budowania modułu dla jednego jądra
+struct KernelBuildResult {
+    std::string kernel;
+    bool success = false;
+    std::chrono::milliseconds duration{0};
+    std::string errorOutput;                    // Wyjście błędów akmods (przy niepowodzeniu)
+};
+
+// Równoległe budowanie modułu akmods dla wielu jąder (akmods --kernels <wersja> --akmod <nazwa>).
+// Każde jądro to osobny przebieg akmods w puli wątków; pamięć podręczną kompilatora i liczbę
+// procesorów dla jednego przebiegu ustawia środowisko polecenia akmods w CommandRunner.
+class AkmodBuilder {
+private:
+    std::shared_ptr<CommandRunner> runner;
+    AkmodBuildOptions options;
+
+public:
+    AkmodBuilder(std::shared_ptr<CommandRunner> runner, AkmodBuildOptions options);
+    
+    // Jądra z katalogiem modułów i nagłówkami (dowiązanie build), posortowane
+    std::vector<std::string> installedKernels() const;
+    
+    // Wyniki w kolejności podanych jąder
+    std::vector<KernelBuildResult> build(const std::vector<std::string>& kernels);
+};
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -5,88 +6,357 @@
 #include <map>
 #include <memory>
 #include <chrono>
+#include <ctime>
 #include <thread>
+#include <mutex>
 #include <filesystem>
+#include <functional>
 #include <cstdlib>
-#include <regex>
+#include <cerrno>
+#include <array>
+#include <set>
+#include <sstream>
 
 // Dla operacji na procesach i plikach
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/signalfd.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <pwd.h>
 #include <signal.h>
+#include <stdlib.h>
+
+#include "akmod-builder.h"
+#include "backup-store.h"
+#include "benchmark-fixtures.h"
+#include "cancellation.h"
+#include "change-journal.h"
+#include "command-runner.h"
+#include "display-config.h"
+#include "driver-selector.h"
+#include "file-utils.h"
+#include "fleet-planner.h"
+#include "graphics-device.h"
+#include "hardware-fingerprint.h"
+#include "health-probe.h"
+#include "install-progress.h"
+#include "json-utils.h"
+#include "kernel-modules.h"
+#include "kmod-waiter.h"
+#include "logger.h"
+#include "package-backend.h"
+#include "pci-names.h"
+#include "pci-scanner.h"
+#include "progress-client.h"
+#include "progress-server.h"
+#include "simulated-backend.h"
+#include "systemd-service.h"
+#include "task-graph.h"
+#include "trace.h"
+#include "transaction-plan.h"
+#include "uevent-monitor.h"
 
 namespace fs = std::filesystem;
 
-// Struktura przechowująca informacje o urządzeniu graficznym
-struct GraphicsDevice {
-    std::string pciId;        // ID urządzenia PCI (np. 10de:1234)
-    std::string vendor;       // Nazwa producenta (NVIDIA, AMD, Intel)
-    std::string model;        // Model karty graficznej
-    std::string currentDriver; // Aktualnie używany sterownik
-    bool isPrimary;           // Czy to główna karta graficzna
-};
+// Domyślne położenie skompilowanej bazy PCI (ustawiane przez CMake)
+#ifndef PCI_DRIVER_DB_PATH
+#define PCI_DRIVER_DB_PATH "/usr/share/auto-driver-installer/pci-driver-db.bin"
+#endif
 
-// Enumeracja typów sterowników
-enum class DriverType {
-    NVIDIA_PROPRIETARY,
-    NVIDIA_OPEN,
-    NVIDIA_NOUVEAU,
-    AMD_PROPRIETARY,
-    AMD_OPEN,
-    INTEL_OPEN,
-    GENERIC,
-    UNKNOWN
+// Opcje wiersza poleceń
+struct InstallerOptions {
+    std::string mode;                // --auto, --daemon, --install-service, --prefetch, --watch, --cancel, --benchmark, --plan, --list-backups, --restore-backup, --rollback lub pusty
+    std::string backupGeneration;    // Generacja kopii zapasowej do przywrócenia
+    std::string benchmarkDir;        // Katalog roboczy benchmarku (pusty: katalog tymczasowy)
+    std::string planDir;             // Katalog migawek sprzętu do zaplanowania
+    std::string planOutputDir = "plans"; // Katalog planów instalacji
+    unsigned jobs = 0;               // Liczba wątków roboczych lub równoległych budowań akmods (0: automatycznie)
+    std::string sysfsRoot = "/sys";  // Katalog główny sysfs (można wskazać drzewo testowe)
+    std::string procRoot = "/proc";  // Katalog główny procfs
+    std::string modulesRoot = "/lib/modules"; // Katalog modułów jądra
+    std::string stateDir = "/var/lib/driver-installer"; // Logi i kopie zapasowe
+    std::string x11Dir = "/etc/X11"; // Konfiguracja serwera X
+    std::string modprobeDir = "/etc/modprobe.d";     // Opcje modułów jądra
+    std::string udevRulesDir = "/etc/udev/rules.d";  // Reguły udev
+    std::string cacheDir = "/var/cache/auto-driver-installer"; // Pobrane pakiety (lokalne repozytorium file://)
+    bool offline = false;            // Pakiety tylko z lokalnego repozytorium, bez sieci
+    std::string socketPath = ProgressServer::defaultPath; // Gniazdo postępu dla interfejsu graficznego
+    std::string pciDatabase = PCI_DRIVER_DB_PATH; // Baza identyfikatorów PCI -> gałąź sterownika
+    std::string pciIds = PciNames::defaultPath;    // Nazwy urządzeń (hwdata), jak w lspci
+    std::chrono::seconds kmodTimeout{900}; // Limit czasu budowania modułu NVIDIA
+    std::chrono::seconds commandTimeout{1800}; // Limit czasu pojedynczego polecenia (np. transakcji dnf)
+    std::chrono::milliseconds healthBudget{250}; // Limit czasu sprawdzenia stanu grafiki po instalacji
+    std::vector<std::string> displayServers; // Nazwy procesów serwerów wyświetlania (puste: domyślne)
+    std::string rpmDatabase;         // Plik bazy rpm do znacznika zmian (pusty: standardowe położenia)
+    bool force = false;              // Pełny przebieg --auto mimo niezmienionego odcisku systemu
+    std::chrono::milliseconds debounce{2000}; // --daemon: cisza kończąca serię zdarzeń udev
+    std::chrono::seconds idleTimeout{0};      // --daemon: zakończenie po czasie bez zdarzeń (0: bez limitu)
+    bool requireRoot = true;         // Czy wymagać uprawnień administratora
+    bool logToJournal = false;       // Dziennik przez natywny protokół journald zamiast stdout
+    bool logToConsole = true;        // Wypisywanie komunikatów na standardowe wyjście
 };
 
 // Klasa do zarządzania sterownikami
 class DriverManager {
 private:
     std::vector<GraphicsDevice> detectedDevices;
+    std::vector<GraphicsDevice> systemDevices;  // Wszystkie karty, także pominięte jako niezmienione
+    DisplayConfigPaths displayPaths;
+    std::string sysfsRoot = "/sys";
+    std::string procRoot = "/proc";
+    std::string modulesRoot = "/lib/modules";
+    std::string stateDir = "/var/lib/driver-installer";
+    std::string x11Dir = "/etc/X11";
+    std::string pciIds = PciNames::defaultPath;
+    std::chrono::seconds kmodTimeout{900};
+    unsigned jobs = 0;               // Równoległe budowania akmods (0: po kolei)
+    HealthProbeOptions healthOptions;
+    bool requireRoot = true;
     std::string backupDir = "/var/lib/driver-installer/backup";
     std::string logFile = "/var/lib/driver-installer/install.log";
     bool rpmFusionEnabled = false;
-    
-    // Mapa przypisująca ID producentów do nazw
-    const std::map<std::string, std::string> vendorMap = {
-        {"10de", "NVIDIA"},
-        {"1002", "AMD"},
-        {"8086", "Intel"}
-    };
+    std::string backupGeneration;    // Generacja kopii zapasowej wykonanej w tym przebiegu
+    std::string lastTransaction;     // Ostatnia znana transakcja w historii dnf
+    bool otherKernelsBuilt = false;  // Czy w tym przebiegu zbudowano już moduły dla pozostałych jąder
+    std::time_t transactionStarted = 0; // Początek transakcji sterowników (akmods działa już w jej posttrans)
+    std::string cacheDir = "/var/cache/auto-driver-installer";
+    bool offline = false;
+    bool seedCache = false;          // --prefetch: wszystkie pakiety planu, także już zainstalowane
+    std::thread prefetchWorker;      // Pobieranie pakietów w tle od końca wykrywania do instalacji
+    bool prefetchSucceeded = false;
+    std::shared_ptr<CommandRunner> runner;
+    std::shared_ptr<SystemCommandRunner> systemRunner; // Ten sam runner bez śledzenia (pusty przy symulacji)
+    std::shared_ptr<PackageBackend> packages;
+    std::shared_ptr<TraceRecorder> trace = std::make_shared<TraceRecorder>();
+    bool installAttempted = false;   // Czy przebieg doszedł do faz instalacji (tylko wtedy zapis metryk)
+    std::unique_ptr<Logger> logger;
+    std::unique_ptr<ChangeJournal> journal; // Zmiany wprowadzone w tym przebiegu (do wycofania)
+    bool journalStarted = false;     // Czy ten przebieg rozpoczął nowy dziennik (--prefetch go nie dotyka)
+    DriverSelector selector;         // Wybór gałęzi sterownika według identyfikatora PCI
+    std::unique_ptr<FingerprintStore> fingerprints; // Stan systemu po ostatnim udanym przebiegu
+    std::vector<std::string> rpmDatabases;           // Kandydaci na plik bazy rpm
+    std::set<std::string> pendingSlots;              // Karty do przetworzenia (puste: wszystkie)
+    std::function<void(const std::string&)> statusCallback; // Postęp dla menedżera usług (STATUS=)
+    std::function<void(const ProgressEvent&)> progressCallback; // Zdarzenia dla gniazda postępu
+    std::string currentPhase;        // Bieżący etap w zdarzeniach postępu
+    std::unique_ptr<DnfProgressParser> transactionProgress; // Postęp z wyjścia transakcji dnf
+    std::unique_ptr<DnfProgressParser> downloadProgress;    // Postęp z wyjścia pobierania w tle
+    std::shared_ptr<Cancellation> cancellation = std::make_shared<Cancellation>(); // Przerwanie na żądanie
 
 public:
-    DriverManager() {
+    // Bez podanych implementacji polecenia i pakiety obsługuje system (dnf)
+    explicit DriverManager(const InstallerOptions& options = InstallerOptions(),
+                           std::shared_ptr<CommandRunner> commandRunner = nullptr,
+                           std::shared_ptr<PackageBackend> packageBackend = nullptr)
+        : sysfsRoot(options.sysfsRoot), procRoot(options.procRoot), modulesRoot(options.modulesRoot),
+          stateDir(options.stateDir), x11Dir(options.x11Dir), pciIds(options.pciIds),
+          kmodTimeout(options.kmodTimeout), jobs(options.jobs),
+          requireRoot(options.requireRoot), backupDir(options.stateDir + "/backup"),
+          logFile(options.stateDir + "/install.log"), cacheDir(options.cacheDir), offline(options.offline),
+          seedCache(options.mode == "--prefetch"), runner(std::move(commandRunner)),
+          packages(std::move(packageBackend)) {
+        if (!runner) {
+            // Zawieszony dnf nie może blokować usługi startowej w nieskończoność
+            auto systemRunner = std::make_shared<SystemCommandRunner>(options.commandTimeout);
+            for (const char* probe : {"lsmod", "rpm"}) {
+                systemRunner->setTimeout(probe, std::chrono::seconds(30));
+            }
+            // Przerwanie zabija działające polecenie (poza transakcjami, w których jest odraczane)
+            // oraz blokuje uruchamianie kolejnych
+            systemRunner->setCancelFd(cancellation->fd());
+            runner = systemRunner;
+            this->systemRunner = systemRunner;
+        }
+        displayPaths.x11Dir = x11Dir;
+        displayPaths.modprobeDir = options.modprobeDir;
+        displayPaths.udevRulesDir = options.udevRulesDir;
+        healthOptions.procRoot = procRoot;
+        healthOptions.sysfsRoot = sysfsRoot;
+        healthOptions.budget = options.healthBudget;
+        if (!options.displayServers.empty()) {
+            healthOptions.displayServers = options.displayServers;
+        }
+        
+        // Każde polecenie zewnętrzne trafia do śladu wykonania
+        runner = std::make_shared<TracingCommandRunner>(runner, trace);
+        transactionProgress = std::make_unique<DnfProgressParser>([this](const ProgressEvent& event) {
+            reportProgress(event);
+        });
+        downloadProgress = std::make_unique<DnfProgressParser>([this](const ProgressEvent& event) {
+            reportProgress(event);
+        });
+        if (!packages) {
+            // Postęp transakcji dnf jest widoczny dla użytkownika tak jak wcześniej, a linia po linii
+            // trafia też do zdarzeń postępu
+            packages = std::make_shared<DnfBackend>(runner, [this](const std::string& line) {
+                std::cout << line << std::flush;
+                transactionProgress->feed(line);
+            });
+        }
+        
         // Utworzenie katalogów, jeśli nie istnieją
-        if (!fs::exists("/var/lib/driver-installer")) {
-            fs::create_directories("/var/lib/driver-installer");
+        if (!fs::exists(stateDir)) {
+            fs::create_directories(stateDir);
         }
         if (!fs::exists(backupDir)) {
             fs::create_directories(backupDir);
         }
+        
+        LoggerOptions logOptions;
+        logOptions.path = logFile;
+        logOptions.journal = options.logToJournal;
+        logOptions.console = options.logToConsole && !options.logToJournal;
+        logger = std::make_unique<Logger>(logOptions);
+        journal = std::make_unique<ChangeJournal>(stateDir + "/journal");
+        fingerprints = std::make_unique<FingerprintStore>(stateDir + "/fingerprint");
+        if (!options.rpmDatabase.empty()) {
+            rpmDatabases = {options.rpmDatabase};
+        } else {
+            rpmDatabases = {"/usr/lib/sysimage/rpm/rpmdb.sqlite", "/var/lib/rpm/rpmdb.sqlite", "/var/lib/rpm/Packages"};
+        }
+        
+        // Baza jest mapowana do pamięci; bez niej wybór opiera się tylko na producencie
+        auto database = std::make_shared<PciDriverDatabase>();
+        if (database->open(options.pciDatabase)) {
+            selector = DriverSelector(database);
+        } else {
+            logMessage("OSTRZEŻENIE: Nie można otworzyć bazy sterowników " + options.pciDatabase +
+                       ", używane są domyślne sterowniki producentów", LogLevel::WARNING);
+        }
     }
-
+    
+    // Zapis śladu wykonania (Chrome trace) i metryk dla kolektora textfile node_exportera
+    ~DriverManager() {
+        // Instalacja anulowana w czasie pobierania: dnf download kończy się sam
+        if (prefetchWorker.joinable()) {
+            prefetchWorker.join();
+        }
+        // Przebieg dobiegł końca; bez znacznika następny przebieg wycofałby jego zmiany jak po awarii
+        if (journalStarted) {
+            journal->finish();
+        }
+        // Szybka ścieżka startu, --prefetch i operacje na kopiach zapasowych nie nadpisują
+        // metryk ostatniej instalacji, na podstawie których działają alerty
+        if (!installAttempted) {
+            return;
+        }
+        try {
+            trace->writeChromeTrace(stateDir + "/trace.json");
+            trace->writePrometheus(stateDir + "/driver-installer.prom");
+        } catch (...) {
+            // Brak metryk nie może przerwać zamykania programu
+        }
+    }
+    
     // Inicjalizacja i uruchomienie procesu instalacji
     bool initialize() {
+        installAttempted = installAttempted || !seedCache;
+        auto span = trace->span("initialize");
         logMessage("Rozpoczęcie procesu automatycznej instalacji sterowników");
+        reportPhase("detect", "Wykrywanie kart graficznych");
         
         // Sprawdzenie, czy skrypt jest uruchomiony z uprawnieniami roota
-        if (geteuid() != 0) {
-            logMessage("BŁĄD: Ten program musi być uruchomiony z uprawnieniami administratora (root)");
+        if (requireRoot && geteuid() != 0) {
+            logMessage("BŁĄD: Ten program musi być uruchomiony z uprawnieniami administratora (root)", LogLevel::ERROR);
+            span.setSuccess(false);
             return false;
         }
         
-        // Wykrycie urządzeń graficznych
-        if (!detectGraphicsDevices()) {
-            logMessage("BŁĄD: Nie udało się wykryć urządzeń graficznych");
-            return false;
+        // Bez sieci wszystkie transakcje korzystają tylko z repozytorium zapisanego przez --prefetch
+        if (offline) {
+            if (!fs::exists(cacheDir + "/repodata/repomd.xml")) {
+                logMessage("BŁĄD: Brak lokalnego repozytorium pakietów w " + cacheDir +
+                           " (należy je przygotować opcją --prefetch)", LogLevel::ERROR);
+                span.setSuccess(false);
+                return false;
+            }
+            packages->useLocalRepository(cacheDir, true);
+            logMessage("Tryb offline: pakiety z lokalnego repozytorium " + cacheDir);
         }
         
-        // Utworzenie kopii zapasowej konfiguracji
-        createBackup();
+        // Pobieranie pakietów nie zmienia sterowników, więc nie może zastąpić dziennika
+        // poprzedniego przebiegu, który nadal da się wycofać przez --rollback
+        if (!seedCache) {
+            // Przebieg przerwany w połowie zmian (awaria, odcięcie zasilania): najpierw jego wycofanie,
+            // bo nowy dziennik usunąłby jedyny zapis tego, co zostało zmienione
+            if (journal->interrupted()) {
+                logMessage("OSTRZEŻENIE: Poprzedni przebieg został przerwany w trakcie zmian; wycofywanie ich przed instalacją",
+                           LogLevel::WARNING);
+                if (!restoreDefaultDrivers()) {
+                    logMessage("BŁĄD: Nie można rozpocząć instalacji przed wycofaniem zmian przerwanego przebiegu "
+                               "(dziennik: " + journal->journalPath() + ")", LogLevel::ERROR);
+                    span.setSuccess(false);
+                    return false;
+                }
+                cancellation->setAllowed(true);
+                reportPhase("detect", "Wykrywanie kart graficznych");
+            }
+            
+            // Nowy przebieg: dziennik opisuje tylko zmiany, które ten przebieg może wprowadzić
+            if (!journal->begin()) {
+                logMessage("OSTRZEŻENIE: Nie można utworzyć dziennika zmian w " + stateDir + "/journal", LogLevel::WARNING);
+            }
+            journalStarted = true;
+        }
         
-        // Sprawdzenie i włączenie repozytoriów
-        enableRepositories();
+        // Fazy niezależne od siebie działają równolegle: sprawdzanie repozytoriów
+        // (dnf repolist czeka głównie na metadane) chowa się za wykrywaniem i kopią zapasową
+        TaskGraph phases;
+        phases.addTask("detect", {}, [this]() {
+            auto phase = trace->span("detect");
+            bool detected = detectGraphicsDevices();
+            phase.setArg("devices", std::to_string(detectedDevices.size()));
+            phase.setSuccess(detected);
+            return detected;
+        });
+        phases.addTask("backup", {}, [this]() {
+            auto phase = trace->span("backup");
+            createBackup();
+            return true;
+        });
+        phases.addTask("repositories-check", {}, [this]() {
+            auto phase = trace->span("repositories-check");
+            checkRepositories();
+            return true;
+        });
+        // Punkt odniesienia dla dziennika: transakcje późniejsze niż ta należą do tego przebiegu
+        phases.addTask("history", {}, [this]() {
+            auto phase = trace->span("history");
+            lastTransaction = packages->lastTransactionId();
+            return true;
+        });
+        // Instalacja repozytoriów zmienia system, więc tylko po udanym wykryciu urządzeń
+        phases.addTask("repositories-enable", {"detect", "repositories-check", "history"}, [this]() {
+            auto phase = trace->span("repositories-enable");
+            enableRepositories();
+            phase.setSuccess(rpmFusionEnabled);
+            return true;
+        });
+        // Pobieranie rusza zaraz po wybraniu pakietów i trwa w tle w czasie kopii zapasowej i pytania o zgodę
+        phases.addTask("prefetch", {"detect", "repositories-enable"}, [this]() {
+            if (!offline) {
+                startPrefetch();
+            }
+            return true;
+        });
+        
+        unsigned int cores = std::thread::hardware_concurrency();
+        phases.run(std::min(4u, cores == 0 ? 2u : cores));
+        
+        if (cancelled()) {
+            logMessage("OSTRZEŻENIE: Inicjalizacja przerwana na żądanie", LogLevel::WARNING);
+            span.setSuccess(false);
+            return false;
+        }
+        if (!phases.succeeded("detect")) {
+            logMessage("BŁĄD: Nie udało się wykryć urządzeń graficznych", LogLevel::ERROR);
+            span.setSuccess(false);
+            return false;
+        }
         
+        span.setSuccess(true);
         return true;
     }
     
@@ -94,37 +364,29 @@ public:
     bool detectGraphicsDevices() {
         logMessage("Wykrywanie urządzeń graficznych...");
         
-        // Użycie komendy lspci do wykrywania kart graficznych
-        std::string output = executeCommand("lspci -nn | grep -E 'VGA|3D|Display'");
-        
-        // Regex do parsowania wyniku lspci
-        std::regex deviceRegex("(.+) VGA compatible controller.*\\[([0-9a-f]{4}):([0-9a-f]{4})\\](?:: (.+))?");
-        std::smatch matches;
-        std::istringstream stream(output);
-        std::string line;
-        
-        while (std::getline(stream, line)) {
-            if (std::regex_search(line, matches, deviceRegex)) {
-                GraphicsDevice device;
-                device.pciId = matches[2].str() + ":" + matches[3].str();
-                
-                // Określanie producenta
-                auto vendorIt = vendorMap.find(matches[2].str());
-                if (vendorIt != vendorMap.end()) {
-                    device.vendor = vendorIt->second;
-                } else {
-                    device.vendor = "Unknown";
-                }
-                
-                device.model = matches.size() > 4 ? matches[4].str() : "Unknown Model";
-                device.isPrimary = detectedDevices.empty(); // Pierwsza wykryta karta jest traktowana jako główna
-                
-                // Sprawdzenie aktualnie używanego sterownika
-                device.currentDriver = detectCurrentDriver(device.pciId);
-                
-                detectedDevices.push_back(device);
-                logMessage("Wykryto urządzenie: " + device.vendor + " " + device.model + " [" + device.pciId + "]");
-            }
+        // Odczyt urządzeń bezpośrednio z sysfs (bez lspci, powłoki i wyrażeń regularnych)
+        PciScanner scanner(sysfsRoot);
+        std::vector<PciDevice> controllers = scanner.scanDisplayControllers();
+        
+        // Jedna migawka /proc/modules dla wszystkich urządzeń
+        DriverResolver resolver(sysfsRoot, std::make_shared<KernelModuleTable>(KernelModuleTable::load(procRoot)));
+        
+        // Nazwy modeli z pci.ids (bez hwdata zostaje nazwa klasy kontrolera)
+        PciNames names;
+        names.load(pciIds);
+        
+        detectedDevices = describeGraphicsDevices(controllers, selector, &resolver, &names);
+        systemDevices = detectedDevices;
+        if (!pendingSlots.empty()) {
+            // Karty bez zmian od ostatniego udanego przebiegu są pomijane
+            detectedDevices.erase(std::remove_if(detectedDevices.begin(), detectedDevices.end(), [this](const GraphicsDevice& device) {
+                return !pendingSlots.count(device.busId);
+            }), detectedDevices.end());
+        }
+        for (const auto& device : detectedDevices) {
+            logMessage("Wykryto urządzenie: " + device.vendor + " " + device.model + " [" + device.pciId + "] (" + device.busId + ")");
+            logMessage("Zalecany sterownik: " + driverTypeName(device.driverType) +
+                       (device.driverFromDatabase ? " (baza PCI)" : " (domyślny dla producenta)"));
         }
         
         return !detectedDevices.empty();
@@ -132,32 +394,132 @@ public:
     
     // Uruchomienie procesu instalacji sterowników
     bool installDrivers() {
+        installAttempted = true;
+        auto span = trace->span("install");
         logMessage("Rozpoczęcie instalacji sterowników...");
         
         bool allSuccess = true;
+        std::set<std::string> unconfiguredSlots;  // Karty bez zainstalowanego sterownika
         
-        for (const auto& device : detectedDevices) {
+        // Pakiety pobrane w tle trafiają do transakcji z lokalnego repozytorium
+        waitForPrefetch();
+        if (cancelled()) {
+            logMessage("OSTRZEŻENIE: Instalacja przerwana na żądanie przed transakcją dnf", LogLevel::WARNING);
+            span.setSuccess(false);
+            return false;
+        }
+        reportPhase("install", "Instalacja pakietów sterowników");
+        
+        // Zebranie pakietów wszystkich urządzeń w jeden plan transakcji
+        InstallSelection selection = selectInstallation(detectedDevices, selector, rpmFusionEnabled);
+        const TransactionPlan& plan = selection.plan;
+        std::vector<const GraphicsDevice*> plannedDevices;
+        for (size_t index : selection.plannedDevices) {
+            plannedDevices.push_back(&detectedDevices[index]);
+        }
+        
+        for (size_t index : selection.unknownDevices) {
+            logMessage("Nieznany producent karty graficznej " + detectedDevices[index].pciId + ". Pomijanie instalacji sterowników.");
+            unconfiguredSlots.insert(detectedDevices[index].busId);
+        }
+        for (size_t index : selection.blockedDevices) {
+            const GraphicsDevice& device = detectedDevices[index];
+            logMessage("BŁĄD: Repozytoria RPM Fusion nie są włączone. Nie można zainstalować sterowników NVIDIA.", LogLevel::ERROR);
+            logMessage("OSTRZEŻENIE: Nie udało się zainstalować sterowników dla " + device.vendor + " " + device.model, LogLevel::WARNING);
+            unconfiguredSlots.insert(device.busId);
+            allSuccess = false;
+        }
+        
+        // Jedna transakcja dnf dla wszystkich urządzeń
+        std::vector<bool> packagesInstalled(plannedDevices.size(), false);
+        if (!plan.empty()) {
+            // Do dnf trafiają tylko pakiety, których nie ma w bazie rpm
+            std::vector<std::string> missing = missingPackages(plan.packages());
+            logMessage("Plan transakcji: " + std::to_string(plan.packages().size()) + " pakietów dla " +
+                       std::to_string(plannedDevices.size()) + " urządzeń (pominięte duplikaty: " +
+                       std::to_string(plan.duplicateCount()) + ", już zainstalowane: " +
+                       std::to_string(plan.packages().size() - missing.size()) + ")");
+            
+            if (!missing.empty()) {
+                reportStatus("Instalacja " + std::to_string(missing.size()) + " pakietów sterowników");
+            }
+            // Zabity w trakcie transakcji rpm dnf zostawia bazę pakietów w połowie zmian, więc
+            // przerwanie czeka na jej koniec (także ponowień) i dopiero potem zatrzymuje instalację
+            cancellation->setDeferred(true);
+            if (!missing.empty()) {
+                transactionStarted = std::time(nullptr);
+                // Punkt odniesienia tuż przed transakcją: w czasie pytania o zgodę mógł działać inny dnf
+                std::string baseline = packages->lastTransactionId();
+                if (!baseline.empty()) {
+                    lastTransaction = baseline;
+                }
+            }
+            auto transaction = trace->span("transaction");
+            transaction.setArg("packages", std::to_string(missing.size()));
+            bool installed = missing.empty() || packages->install(missing);
+            transaction.setSuccess(installed);
+            if (!missing.empty()) {
+                recordTransaction("drivers");
+            }
+            
+            if (installed) {
+                packagesInstalled.assign(plannedDevices.size(), true);
+            } else if (plannedDevices.size() > 1 && !cancelled()) {
+                // Błąd jednego urządzenia nie powinien blokować pozostałych
+                logMessage("OSTRZEŻENIE: Zbiorcza transakcja nie powiodła się, ponowienie osobno dla każdego urządzenia", LogLevel::WARNING);
+                for (size_t i = 0; i < plannedDevices.size() && !cancelled(); ++i) {
+                    const auto& entry = plan.deviceEntries()[i];
+                    auto retry = trace->span("transaction-retry");
+                    retry.setArg("device", plannedDevices[i]->busId);
+                    std::vector<std::string> entryMissing = missingPackages(entry.packages);
+                    packagesInstalled[i] = entryMissing.empty() || packages->install(entryMissing);
+                    retry.setSuccess(packagesInstalled[i]);
+                    if (!entryMissing.empty()) {
+                        recordTransaction("drivers");
+                    }
+                }
+            }
+            cancellation->setDeferred(false);
+        }
+        
+        // Konfiguracja i raport dla każdego urządzenia osobno
+        for (size_t i = 0; i < plannedDevices.size(); ++i) {
+            const GraphicsDevice& device = *plannedDevices[i];
             logMessage("Instalacja sterowników dla: " + device.vendor + " " + device.model);
             
             bool success = false;
+            auto configure = trace->span("configure");
+            configure.setArg("device", device.busId);
             
-            if (device.vendor == "NVIDIA") {
-                success = installNvidiaDrivers(device);
+            if (!packagesInstalled[i]) {
+                logMessage("BŁĄD: Nie udało się zainstalować pakietów sterowników " + device.vendor, LogLevel::ERROR);
+            } else if (DriverSelector::requiresAkmod(device.driverType)) {
+                success = configureNvidiaDrivers(device);
+            } else if (device.driverType == DriverType::NVIDIA_NOUVEAU) {
+                success = configureNouveauDrivers(device);
             } else if (device.vendor == "AMD") {
-                success = installAmdDrivers(device);
+                success = configureAmdDrivers(device);
             } else if (device.vendor == "Intel") {
-                success = installIntelDrivers(device);
-            } else {
-                logMessage("Nieznany producent karty graficznej. Pomijanie instalacji sterowników.");
-                continue;
+                success = configureIntelDrivers(device);
             }
             
+            configure.setSuccess(success);
             if (!success) {
-                logMessage("OSTRZEŻENIE: Nie udało się zainstalować sterowników dla " + device.vendor + " " + device.model);
+                logMessage("OSTRZEŻENIE: Nie udało się zainstalować sterowników dla " + device.vendor + " " + device.model, LogLevel::WARNING);
+                unconfiguredSlots.insert(device.busId);
                 allSuccess = false;
             }
         }
         
+        // Jeden zestaw plików konfiguracji dla całego układu kart; przerwana instalacja go nie zmienia
+        if (cancelled()) {
+            logMessage("OSTRZEŻENIE: Instalacja przerwana na żądanie", LogLevel::WARNING);
+            allSuccess = false;
+        } else if (!writeDisplayConfiguration(unconfiguredSlots)) {
+            allSuccess = false;
+        }
+        
+        span.setSuccess(allSuccess);
         if (allSuccess) {
             logMessage("Instalacja sterowników zakończona pomyślnie");
         } else {
@@ -169,261 +531,796 @@ public:
     
     // Testowanie zainstalowanych sterowników
     bool testDrivers() {
+        auto span = trace->span("test");
         logMessage("Testowanie zainstalowanych sterowników...");
+        reportPhase("test", "Sprawdzanie działania sterowników");
         
-        // W rzeczywistej implementacji moglibyśmy uruchomić testy wydajności lub stabilności
-        // Uproszczona implementacja po prostu sprawdza, czy system nadal działa poprawnie
+        // Serwer wyświetlania (X11 lub kompozytor Wayland) i stan kart DRM bez uruchamiania procesów
+        std::vector<std::string> slots;
+        for (const auto& device : detectedDevices) {
+            slots.push_back(device.busId);
+        }
+        HealthReport report = HealthProbe(healthOptions).run(slots);
         
-        // Sprawdzenie, czy proces X11 lub Wayland nadal działa
-        bool displayServerRunning = false;
+        for (const auto& gpu : report.gpus) {
+            logMessage("Stan karty " + gpu.slot + ": " + gpu.verdict,
+                       gpu.healthy ? LogLevel::INFO : LogLevel::ERROR);
+        }
+        std::string servers;
+        for (const auto& server : report.displayServers) {
+            servers += (servers.empty() ? "" : ", ") + server;
+        }
+        logMessage("Serwery wyświetlania: " + (servers.empty() ? std::string("brak") : servers) + " (sprawdzenie: " +
+                   std::to_string(report.duration.count() / 1000) + " ms)");
+        span.setArg("display_servers", servers);
         
-        if (system("pgrep -x Xorg > /dev/null") == 0 || 
-            system("pgrep -x X > /dev/null") == 0 ||
-            system("pgrep -x wayland > /dev/null") == 0) {
-            displayServerRunning = true;
+        if (!report.healthy() && report.timedOut) {
+            // Brak wyniku to nie dowód awarii; wycofanie kosztuje pełną transakcję dnf
+            logMessage("OSTRZEŻENIE: Sprawdzenie stanu grafiki przekroczyło limit " +
+                       std::to_string(healthOptions.budget.count()) + " ms, wynik niepełny", LogLevel::WARNING);
+            return true;
         }
         
-        if (!displayServerRunning) {
-            logMessage("BŁĄD: Serwer wyświetlania nie działa po instalacji sterowników!");
+        span.setSuccess(report.healthy());
+        if (!report.healthy()) {
+            logMessage("BŁĄD: Serwer wyświetlania nie działa po instalacji sterowników!", LogLevel::ERROR);
             return false;
         }
         
-        // Dodatkowe testy można by dodać tutaj
-        
         logMessage("Pomyślnie przetestowano sterowniki");
         return true;
     }
     
-    // Przywracanie domyślnych sterowników w przypadku niepowodzenia
+    // Przywracanie stanu sprzed instalacji w przypadku niepowodzenia: dziennik zmian
+    // odtwarzany jest w odwrotnej kolejności, a transakcje dnf cofa jedna transakcja
     bool restoreDefaultDrivers() {
+        installAttempted = true;
+        auto span = trace->span("restore");
         logMessage("Przywracanie domyślnych sterowników...");
         
-        // Przywrócenie kopii zapasowej konfiguracji
-        if (fs::exists(backupDir + "/xorg.conf") && fs::exists("/etc/X11/xorg.conf")) {
-            executeCommand("cp " + backupDir + "/xorg.conf /etc/X11/xorg.conf");
+        // Wycofywania nie wolno przerwać w połowie; wcześniejsze żądanie przerwania zostało już obsłużone
+        cancellation->setAllowed(false);
+        cancellation->reset();
+        reportPhase("rollback", "Wycofywanie zmian");
+        
+        std::vector<ChangeRecord> changes = journal->records();
+        span.setArg("changes", std::to_string(changes.size()));
+        if (changes.empty()) {
+            logMessage("Dziennik zmian jest pusty, nie ma czego wycofywać");
+            return true;
         }
         
-        for (const auto& device : detectedDevices) {
-            if (device.vendor == "NVIDIA") {
-                // Usunięcie sterownika NVIDIA i instalacja nouveau
-                executeCommand("dnf remove -y akmod-nvidia xorg-x11-drv-nvidia*");
-                executeCommand("dnf install -y xorg-x11-drv-nouveau");
-            } else if (device.vendor == "AMD") {
-                // Przywrócenie domyślnych sterowników radeon/amdgpu
-                executeCommand("dnf reinstall -y mesa-dri-drivers mesa-libGL xorg-x11-drv-amdgpu");
+        bool success = true;
+        std::vector<std::string> transactions;  // Transakcje dnf tego przebiegu w kolejności zapisu
+        
+        for (auto it = changes.rbegin(); it != changes.rend(); ++it) {
+            const ChangeRecord& change = *it;
+            if (change.kind == ChangeKind::FILE) {
+                if (!journal->restoreFile(change)) {
+                    logMessage("BŁĄD: Nie udało się przywrócić pliku " + change.subject, LogLevel::ERROR);
+                    success = false;
+                } else if (change.hash == "-") {
+                    logMessage("Usunięto: " + change.subject);
+                } else {
+                    logMessage("Przywrócono: " + change.subject);
+                }
+            } else if (change.kind == ChangeKind::MODULE) {
+                // Pakiet kmod zbudowany przez akmods to osobna, późniejsza transakcja
+                logMessage("Moduł " + change.subject + " zostanie usunięty razem z pakietem kmod");
+            } else if (change.detail == "repositories") {
+                // Włączone repozytoria nie wpływają na działanie grafiki
+                logMessage("Repozytoria RPM Fusion pozostają włączone (transakcja " + change.subject + ")");
+            } else {
+                transactions.insert(transactions.begin(), change.subject);
             }
-            // Dla Intela zwykle nie ma potrzeby przywracania, ponieważ używa się sterowników open source
         }
         
+        if (!transactions.empty() && !undoTransactions(transactions)) {
+            success = false;
+        }
+        
+        span.setSuccess(success);
+        if (!success) {
+            logMessage("BŁĄD: Nie wszystkie zmiany udało się wycofać (dziennik: " + journal->journalPath() + ")", LogLevel::ERROR);
+            return false;
+        }
+        
+        // Wycofane zmiany nie mogą zostać wycofane drugi raz, a odcisk nie opisuje już systemu
+        journal->begin();
+        fingerprints->clear();
         logMessage("Przywrócono domyślne sterowniki");
         return true;
     }
     
-    // Uzyskanie listy wykrytych urządzeń
-    const std::vector<GraphicsDevice>& getDetectedDevices() const {
-        return detectedDevices;
-    }
-
-private:
-    // Wykrywanie aktualnie używanego sterownika
-    std::string detectCurrentDriver(const std::string& pciId) {
-        // Wyciągnięcie ID producenta z PCI ID
-        std::string vendorId = pciId.substr(0, 4);
-        
-        if (vendorId == "10de") { // NVIDIA
-            if (system("lsmod | grep -q nouveau") == 0) {
-                return "nouveau";
-            } else if (system("lsmod | grep -q nvidia") == 0) {
-                return "nvidia";
-            }
-        } else if (vendorId == "1002") { // AMD
-            if (system("lsmod | grep -q amdgpu") == 0) {
-                return "amdgpu";
-            } else if (system("lsmod | grep -q radeon") == 0) {
-                return "radeon";
+    // Wycofanie transakcji dnf tego przebiegu (w kolejności zapisu). rollback cofa wszystko od
+    // pierwszej transakcji, także cudze, więc jest używany tylko wtedy, gdy dziennik obejmuje
+    // każdą transakcję od pierwszej do ostatniej w historii; inaczej undo każdej od najnowszej.
+    bool undoTransactions(const std::vector<std::string>& transactions) {
+        bool contiguous = transactions.size() > 1;
+        for (size_t i = 0; contiguous && i < transactions.size(); ++i) {
+            contiguous = !transactions[i].empty() && transactions[i].find_first_not_of("0123456789") == std::string::npos &&
+                         (i == 0 || std::stoul(transactions[i]) == std::stoul(transactions[i - 1]) + 1);
+        }
+        if (contiguous && packages->lastTransactionId() == transactions.back()) {
+            logMessage("Wycofywanie transakcji dnf " + transactions.front() + "-" + transactions.back() + "...");
+            if (packages->rollbackTransactions(transactions.front())) {
+                return true;
             }
-        } else if (vendorId == "8086") { // Intel
-            return "intel";
+            logMessage("BŁĄD: Nie udało się wycofać transakcji dnf od " + transactions.front(), LogLevel::ERROR);
+            return false;
         }
         
-        return "unknown";
+        bool success = true;
+        for (auto it = transactions.rbegin(); it != transactions.rend(); ++it) {
+            logMessage("Wycofywanie transakcji dnf " + *it + "...");
+            if (!packages->undoTransaction(*it)) {
+                logMessage("BŁĄD: Nie udało się wycofać transakcji dnf " + *it, LogLevel::ERROR);
+                success = false;
+            }
+        }
+        return success;
     }
     
-    // Instalacja sterowników NVIDIA
-    bool installNvidiaDrivers(const GraphicsDevice& device) {
-        logMessage("Instalacja sterowników NVIDIA...");
-        
-        // Sprawdzenie, czy RPM Fusion jest włączone
-        if (!rpmFusionEnabled) {
-            logMessage("BŁĄD: Repozytoria RPM Fusion nie są włączone. Nie można zainstalować sterowników NVIDIA.");
+    // Przywrócenie plików konfiguracyjnych z wybranej generacji kopii (pusta: najnowsza)
+    bool restoreBackup(const std::string& generation) {
+        BackupStore store(backupDir);
+        std::string id = generation.empty() ? store.latestGeneration() : generation;
+        if (id.empty()) {
+            logMessage("OSTRZEŻENIE: Brak kopii zapasowej konfiguracji do przywrócenia", LogLevel::WARNING);
             return false;
         }
         
-        // Instalacja sterowników NVIDIA
-        int result = system("dnf install -y akmod-nvidia xorg-x11-drv-nvidia xorg-x11-drv-nvidia-cuda");
+        std::vector<std::string> restored;
+        bool success = store.restore(id, &restored);
+        for (const auto& path : restored) {
+            logMessage("Przywrócono: " + path);
+        }
         
-        if (result != 0) {
-            logMessage("BŁĄD: Nie udało się zainstalować sterowników NVIDIA");
+        if (!success) {
+            logMessage("BŁĄD: Nie udało się przywrócić kopii zapasowej " + id, LogLevel::ERROR);
             return false;
         }
+        logMessage("Przywrócono konfigurację z kopii zapasowej " + id);
+        return true;
+    }
+    
+    // Generacje kopii zapasowych od najstarszej do najnowszej
+    std::vector<std::string> listBackups() const {
+        return BackupStore(backupDir).generations();
+    }
+    
+    // Oczekiwanie na zapisanie wszystkich komunikatów (np. przed pytaniem użytkownika)
+    void flushLog() {
+        logger->flush();
+    }
+    
+    // Szybka ścieżka --auto: czy od ostatniego udanego przebiegu zmieniły się karty, jądro
+    // lub pakiety sterowników. Przy zmianie ogranicza dalszy przebieg do zmienionych kart.
+    bool hasPendingChanges() {
+        auto span = trace->span("fingerprint");
+        if (journal->interrupted()) {
+            logMessage("Poprzedni przebieg został przerwany w trakcie zmian, pełny przebieg instalacji");
+            return true;
+        }
+        HardwareFingerprint previous;
+        if (!fingerprints->load(previous)) {
+            logMessage("Brak zapisanego stanu systemu, pełny przebieg instalacji");
+            return true;
+        }
         
-        // Odczekanie na skompilowanie modułu kernela
-        logMessage("Oczekiwanie na zbudowanie modułu jądra NVIDIA...");
-        std::this_thread::sleep_for(std::chrono::seconds(60));
+        HardwareFingerprint current = captureFingerprint();
+        current.packages = previous.packages;
+        FingerprintChanges changes = compareFingerprints(previous, current);
+        std::set<std::string> changed(changes.changedSlots.begin(), changes.changedSlots.end());
         
-        // Sprawdzenie, czy moduł został poprawnie skompilowany
-        if (system("lsmod | grep -q nvidia") != 0) {
-            logMessage("OSTRZEŻENIE: Moduł NVIDIA nie został załadowany");
-            return false;
+        // Nowe jądro wymaga modułów akmods zbudowanych od nowa
+        if (changes.kernel) {
+            logMessage("Zmiana jądra: " + previous.kernelRelease + " -> " + current.kernelRelease);
+            for (const auto& device : current.devices) {
+                if (DriverSelector::requiresAkmod(device.driverType)) {
+                    changed.insert(device.slot);
+                }
+            }
+        }
+        
+        // Baza rpm się zmieniła: jedno zapytanie rpm o wersje pakietów sterowników
+        if (changes.packageDb && !previous.packages.empty()) {
+            std::vector<std::string> names;
+            for (const auto& package : previous.packages) {
+                names.push_back(package.first);
+            }
+            current.packages = packages->installedVersions(names);
+            for (const auto& package : previous.packages) {
+                auto it = current.packages.find(package.first);
+                if (it != current.packages.end() && it->second == package.second) {
+                    continue;
+                }
+                logMessage("Zmieniony pakiet sterownika: " + package.first);
+                for (const auto& device : current.devices) {
+                    std::vector<std::string> devicePackages = selector.packagesFor(device.driverType);
+                    if (std::find(devicePackages.begin(), devicePackages.end(), package.first) != devicePackages.end()) {
+                        changed.insert(device.slot);
+                    }
+                }
+            }
         }
         
-        // Konfiguracja pliku xorg.conf
-        system("nvidia-xconfig");
+        span.setArg("changed", std::to_string(changed.size()));
+        if (changed.empty()) {
+            // Usunięte karty lub aktualizacje innych pakietów: wystarczy odświeżyć odcisk
+            if (changes.any()) {
+                fingerprints->save(current);
+            }
+            logMessage("Karty, jądro i pakiety sterowników bez zmian od ostatniego przebiegu");
+            return false;
+        }
         
-        logMessage("Pomyślnie zainstalowano sterowniki NVIDIA");
+        std::string slots;
+        for (const auto& slot : changed) {
+            slots += (slots.empty() ? "" : ", ") + slot;
+        }
+        logMessage("Przetwarzanie tylko zmienionych kart: " + slots);
+        pendingSlots = changed;
         return true;
     }
     
-    // Instalacja sterowników AMD
-    bool installAmdDrivers(const GraphicsDevice& device) {
-        logMessage("Instalacja sterowników AMD...");
+    // Zapis odcisku po udanym przebiegu (wszystkie karty, nie tylko przetworzone)
+    void saveFingerprint() {
+        HardwareFingerprint fingerprint = captureFingerprint();
+        std::vector<std::string> names;
+        for (const auto& device : fingerprint.devices) {
+            for (const auto& package : selector.packagesFor(device.driverType)) {
+                if (std::find(names.begin(), names.end(), package) == names.end()) {
+                    names.push_back(package);
+                }
+            }
+        }
+        fingerprint.packages = packages->installedVersions(names);
+        if (!fingerprints->save(fingerprint)) {
+            logMessage("OSTRZEŻENIE: Nie można zapisać stanu systemu w " + fingerprints->filePath(), LogLevel::WARNING);
+        }
+    }
+    
+    // Zakończenie pobierania w tle; po udanym transakcje biorą pakiety z lokalnego repozytorium
+    bool waitForPrefetch() {
+        if (!prefetchWorker.joinable()) {
+            return true;
+        }
         
-        // Instalacja sterowników AMDGPU i Mesa
-        int result = system("dnf install -y mesa-dri-drivers mesa-libGL mesa-vulkan-drivers xorg-x11-drv-amdgpu");
+        reportPhase("download", "Pobieranie pakietów sterowników");
+        reportStatus("Pobieranie pakietów sterowników");
+        prefetchWorker.join();
+        if (prefetchSucceeded) {
+            packages->useLocalRepository(cacheDir, offline);
+            logMessage("Pakiety pobrane do lokalnego repozytorium " + cacheDir);
+        } else {
+            logMessage("OSTRZEŻENIE: Nie udało się pobrać pakietów z wyprzedzeniem; dnf pobierze je podczas instalacji",
+                       LogLevel::WARNING);
+        }
+        return prefetchSucceeded;
+    }
+    
+    // Krótki opis bieżącego etapu (np. dla systemctl status)
+    void setStatusCallback(std::function<void(const std::string&)> callback) {
+        statusCallback = std::move(callback);
+    }
+    
+    // Zdarzenia postępu (etapy, pakiety, komunikaty); wywoływane także z wątku pobierania w tle
+    void setProgressCallback(std::function<void(const ProgressEvent&)> callback) {
+        progressCallback = std::move(callback);
+    }
+    
+    // Żądanie przerwania (np. z gniazda postępu): polecenia i oczekiwanie na moduł kończą się od razu.
+    // Obiekt przeżywa menedżera, więc może go trzymać wątek gniazda.
+    std::shared_ptr<Cancellation> cancellationToken() const {
+        return cancellation;
+    }
+    
+    bool cancelled() const {
+        return cancellation->isRequested();
+    }
+    
+    // Uzyskanie listy wykrytych urządzeń
+    const std::vector<GraphicsDevice>& getDetectedDevices() const {
+        return detectedDevices;
+    }
+
+private:
+    // Konfiguracja sterowników NVIDIA po instalacji pakietów
+    bool configureNvidiaDrivers(const GraphicsDevice& device) {
+        logMessage("Konfiguracja sterowników NVIDIA...");
         
-        if (result != 0) {
-            logMessage("BŁĄD: Nie udało się zainstalować sterowników AMD");
+        // Oczekiwanie na zbudowanie modułu przez akmods (kończy się, gdy moduł jest gotowy)
+        logMessage("Oczekiwanie na zbudowanie modułu jądra NVIDIA...");
+        reportPhase("build", "Budowanie modułu jądra NVIDIA");
+        reportStatus("Oczekiwanie na zbudowanie modułu jądra NVIDIA przez akmods");
+        KmodWaitOptions waitOptions;
+        waitOptions.procRoot = procRoot;
+        waitOptions.modulesRoot = modulesRoot;
+        waitOptions.timeout = kmodTimeout;
+        waitOptions.cancelFd = cancellation->fd();
+        waitOptions.buildStarted = transactionStarted;
+        KmodWaiter waiter(waitOptions);
+        
+        // Działające jądro buduje akmods uruchomiony przez instalację pakietu. Oczekiwanie śledzi
+        // każdy proces akmods, więc pozostałe jądra są budowane dopiero po nim: inaczej gotowość
+        // modułu dla działającego jądra czekałaby na wszystkie budowania i mogła przekroczyć limit.
+        auto waitStart = std::chrono::steady_clock::now();
+        KmodWaitResult waitResult;
+        {
+            auto span = trace->span("kmod-wait");
+            waitResult = waiter.wait();
+            span.setSuccess(waitResult == KmodWaitResult::READY);
+        }
+        auto waited = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - waitStart);
+        
+        if (waitResult == KmodWaitResult::BUILD_FAILED) {
+            logMessage("BŁĄD: akmods nie zbudował modułu NVIDIA (szczegóły w /var/cache/akmods)", LogLevel::ERROR);
+            return false;
+        }
+        if (waitResult == KmodWaitResult::CANCELLED) {
+            logMessage("OSTRZEŻENIE: Oczekiwanie na moduł NVIDIA przerwane na żądanie", LogLevel::WARNING);
             return false;
         }
+        if (waitResult == KmodWaitResult::TIMEOUT) {
+            logMessage("OSTRZEŻENIE: Moduł NVIDIA nie został zbudowany w ciągu " + std::to_string(kmodTimeout.count()) + " s", LogLevel::WARNING);
+            return false;
+        }
+        logMessage("Moduł NVIDIA zbudowany w " + waiter.moduleDirectory() + " po " + std::to_string(waited.count()) + " s");
+        journal->recordModuleChange("nvidia", "built");
+        recordTransaction("kmod", 1);
         
-        // Konfiguracja dla AMD
-        std::ofstream xorgConf("/etc/X11/xorg.conf.d/20-amdgpu.conf");
-        if (xorgConf.is_open()) {
-            xorgConf << "Section \"Device\"\n";
-            xorgConf << "    Identifier \"AMD\"\n";
-            xorgConf << "    Driver \"amdgpu\"\n";
-            xorgConf << "    Option \"TearFree\" \"true\"\n";
-            xorgConf << "EndSection\n";
-            xorgConf.close();
+        // Pozostałe zainstalowane jądra teraz, a nie dopiero przy ich starcie. akmods kończy
+        // instalacją pakietu kmod, więc przerwanie czeka na koniec budowania jak przy transakcji.
+        cancellation->setDeferred(true);
+        std::vector<KernelBuildResult> builds = buildModulesForOtherKernels();
+        cancellation->setDeferred(false);
+        size_t kernelsBuilt = 0;
+        for (const auto& build : builds) {
+            std::string seconds = std::to_string(build.duration.count() / 1000) + "." +
+                                  std::to_string(build.duration.count() % 1000 / 100) + " s";
+            if (build.success) {
+                logMessage("Moduł NVIDIA dla jądra " + build.kernel + " zbudowany w " + seconds);
+                journal->recordModuleChange("nvidia", "built " + build.kernel);
+                ++kernelsBuilt;
+            } else {
+                logMessage("OSTRZEŻENIE: Nie udało się zbudować modułu NVIDIA dla jądra " + build.kernel + " (" + seconds +
+                           "); akmods spróbuje ponownie przy jego starcie", LogLevel::WARNING);
+            }
+        }
+        if (kernelsBuilt > 0) {
+            recordTransaction("kmod", kernelsBuilt);
         }
         
-        logMessage("Pomyślnie zainstalowano sterowniki AMD");
+        // Przy aktywnym nouveau moduł zostanie załadowany dopiero po ponownym uruchomieniu
+        if (!KernelModuleTable::load(procRoot).isLoaded("nvidia")) {
+            logMessage("Moduł NVIDIA zostanie załadowany po ponownym uruchomieniu systemu");
+        }
+        
+        logMessage("Pomyślnie zainstalowano sterowniki NVIDIA");
         return true;
     }
     
-    // Instalacja sterowników Intel
-    bool installIntelDrivers(const GraphicsDevice& device) {
-        logMessage("Instalacja sterowników Intel...");
+    // Budowanie modułu NVIDIA dla zainstalowanych jąder innych niż działające
+    std::vector<KernelBuildResult> buildModulesForOtherKernels() {
+        // Kilka kart NVIDIA korzysta z tego samego modułu
+        if (otherKernelsBuilt) {
+            return {};
+        }
+        otherKernelsBuilt = true;
         
-        // Instalacja sterowników Intel
-        int result = system("dnf install -y mesa-dri-drivers mesa-libGL xorg-x11-drv-intel");
+        AkmodBuildOptions buildOptions;
+        buildOptions.modulesRoot = modulesRoot;
+        AkmodBuilder builder(runner, buildOptions);
         
-        if (result != 0) {
-            logMessage("BŁĄD: Nie udało się zainstalować sterowników Intel");
-            return false;
+        std::vector<std::string> kernels = builder.installedKernels();
+        kernels.erase(std::remove(kernels.begin(), kernels.end(), KmodWaiter::runningKernelRelease()), kernels.end());
+        if (kernels.empty()) {
+            return {};
+        }
+        
+        // Przebiegi akmods czekają na wspólną blokadę, więc domyślnie jądra są budowane po kolei
+        // na wszystkich procesorach; równoczesne przebiegi (--jobs) liczyłyby też czas oczekiwania
+        unsigned int cores = std::thread::hardware_concurrency();
+        buildOptions.jobs = jobs ? jobs : 1;
+        size_t parallel = std::min<size_t>(buildOptions.jobs, kernels.size());
+        if (systemRunner) {
+            // Pamięć podręczna ccache w katalogu stanu: po aktualizacji jądra przebudowa używa
+            // wcześniejszych obiektów. Procesory są dzielone między równoległe przebiegi akmods.
+            std::string compilerCache = prepareCompilerCache();
+            const char* path = std::getenv("PATH");
+            std::vector<std::string> environment = {
+                "RPM_BUILD_NCPUS=" + std::to_string(std::max<size_t>(1, (cores == 0 ? 2 : cores) / parallel))
+            };
+            if (!compilerCache.empty()) {
+                environment.push_back("CCACHE_DIR=" + compilerCache);
+                environment.push_back("PATH=/usr/lib64/ccache:" + std::string(path ? path : "/usr/sbin:/usr/bin"));
+            }
+            systemRunner->setEnvironment("akmods", environment);
         }
         
-        // Konfiguracja dla Intel
-        std::ofstream xorgConf("/etc/X11/xorg.conf.d/20-intel.conf");
-        if (xorgConf.is_open()) {
-            xorgConf << "Section \"Device\"\n";
-            xorgConf << "    Identifier \"Intel Graphics\"\n";
-            xorgConf << "    Driver \"intel\"\n";
-            xorgConf << "    Option \"TearFree\" \"true\"\n";
-            xorgConf << "EndSection\n";
-            xorgConf.close();
+        logMessage("Budowanie modułu NVIDIA dla " + std::to_string(kernels.size()) + " pozostałych jąder (równolegle: " +
+                   std::to_string(parallel) + ")");
+        auto span = trace->span("akmods-build");
+        span.setArg("kernels", std::to_string(kernels.size()));
+        std::vector<KernelBuildResult> results = AkmodBuilder(runner, buildOptions).build(kernels);
+        span.setSuccess(std::all_of(results.begin(), results.end(), [](const KernelBuildResult& result) {
+            return result.success;
+        }));
+        return results;
+    }
+    
+    // Katalog ccache należący do użytkownika akmods, który buduje moduły (pusty: niedostępny)
+    std::string prepareCompilerCache() {
+        std::string cacheDir = stateDir + "/ccache";
+        std::error_code error;
+        fs::create_directories(cacheDir, error);
+        if (!fs::is_directory(cacheDir, error)) {
+            return "";
         }
         
+        // Bez prawa zapisu dla innych: zatruty obiekt trafiłby do modułu jądra
+        if (const passwd* akmodsUser = getpwnam("akmods")) {
+            if (chown(cacheDir.c_str(), akmodsUser->pw_uid, akmodsUser->pw_gid) != 0) {
+                return "";
+            }
+        }
+        fs::permissions(cacheDir, fs::perms::owner_all | fs::perms::group_read | fs::perms::group_exec |
+                        fs::perms::others_read | fs::perms::others_exec, error);
+        return cacheDir;
+    }
+    
+    // Konfiguracja karty NVIDIA bez wspieranego sterownika własnościowego (Curie, Tesla)
+    bool configureNouveauDrivers(const GraphicsDevice& device) {
+        logMessage("Karta " + device.pciId + " nie jest obsługiwana przez sterowniki NVIDIA; pozostaje nouveau");
+        return true;
+    }
+    
+    // Konfiguracja sterowników AMD po instalacji pakietów (plik X zapisuje writeDisplayConfiguration)
+    bool configureAmdDrivers(const GraphicsDevice& device) {
+        logMessage("Konfiguracja sterowników AMD...");
+        logMessage("Pomyślnie zainstalowano sterowniki AMD");
+        return true;
+    }
+    
+    // Konfiguracja sterowników Intel po instalacji pakietów (plik X zapisuje writeDisplayConfiguration)
+    bool configureIntelDrivers(const GraphicsDevice& device) {
+        logMessage("Konfiguracja sterowników Intel...");
         logMessage("Pomyślnie zainstalowano sterowniki Intel");
         return true;
     }
     
+    // Konfiguracja X wszystkich kart naraz (BusID, karta główna, PRIME render offload, runtime D3).
+    // Karty, których sterownik nie jest zainstalowany, są pomijane; karty bez zmian od ostatniego
+    // przebiegu zachowują sterownik zainstalowany wcześniej. Pliki, które przestały obowiązywać
+    // (np. runtime D3 po odłączeniu eGPU), są usuwane.
+    bool writeDisplayConfiguration(const std::set<std::string>& skippedSlots) {
+        auto span = trace->span("display-config");
+        reportPhase("configure", "Konfiguracja serwera X");
+        std::vector<GraphicsDevice> devices;
+        for (const auto& device : systemDevices) {
+            if (!skippedSlots.count(device.busId)) {
+                devices.push_back(device);
+            }
+        }
+        
+        bool success = true;
+        DisplayConfigGenerator generator(displayPaths);
+        std::vector<DisplayConfigFile> files = generator.generate(devices);
+        for (const auto& file : files) {
+            success = writeConfigFile(file.path, file.contents) && success;
+        }
+        for (const auto& path : generator.obsoleteFiles(files)) {
+            success = removeConfigFile(path) && success;
+        }
+        span.setSuccess(success);
+        return success;
+    }
+    
+    // Karty z sysfs, jądro i znacznik bazy rpm; bez uruchamiania procesów
+    HardwareFingerprint captureFingerprint() {
+        HardwareFingerprint fingerprint;
+        fingerprint.kernelRelease = KmodWaiter::runningKernelRelease();
+        fingerprint.packageDbStamp = packageDatabaseStamp(rpmDatabases);
+        for (const auto& controller : PciScanner(sysfsRoot).scanDisplayControllers()) {
+            fingerprint.devices.push_back({controller.slot, PciScanner::formatId(controller.vendorId, controller.deviceId),
+                                           selector.select(controller.vendorId, controller.deviceId).type});
+        }
+        return fingerprint;
+    }
+    
     // Utworzenie kopii zapasowej aktualnej konfiguracji
     void createBackup() {
         logMessage("Tworzenie kopii zapasowej konfiguracji...");
         
-        // Backup /etc/X11/xorg.conf jeśli istnieje
-        if (fs::exists("/etc/X11/xorg.conf")) {
-            executeCommand("cp /etc/X11/xorg.conf " + backupDir + "/xorg.conf");
+        // Lista załadowanych modułów (same nazwy, aby liczniki odwołań nie tworzyły nowych generacji)
+        std::string modules;
+        for (const auto& name : KernelModuleTable::load(procRoot).names()) {
+            modules += name + "\n";
         }
         
-        // Backup katalogu xorg.conf.d
-        if (fs::exists("/etc/X11/xorg.conf.d")) {
-            executeCommand("mkdir -p " + backupDir + "/xorg.conf.d");
-            executeCommand("cp -r /etc/X11/xorg.conf.d/* " + backupDir + "/xorg.conf.d/");
+        // xorg.conf i xorg.conf.d w magazynie adresowanym treścią; niezmienione pliki nic nie kosztują
+        BackupStore store(backupDir);
+        SnapshotResult snapshot = store.snapshot({x11Dir + "/xorg.conf", x11Dir + "/xorg.conf.d"}, {{"@modules", modules}});
+        if (!snapshot.success) {
+            logMessage("BŁĄD: Nie udało się utworzyć kopii zapasowej konfiguracji", LogLevel::ERROR);
+            return;
         }
+        backupGeneration = snapshot.generation;
         
-        // Backup aktualnych modułów jądra
-        executeCommand("lsmod > " + backupDir + "/lsmod.txt");
-        
-        logMessage("Kopia zapasowa została utworzona");
+        if (snapshot.created) {
+            logMessage("Kopia zapasowa została utworzona: " + snapshot.generation + " (odczytane pliki: " +
+                       std::to_string(snapshot.filesHashed) + ", bez zmian: " + std::to_string(snapshot.filesReused) +
+                       ", nowe obiekty: " + std::to_string(snapshot.objectsStored) + ")");
+        } else {
+            logMessage("Konfiguracja bez zmian, używana jest kopia zapasowa " + snapshot.generation);
+        }
     }
     
-    // Włączenie potrzebnych repozytoriów (RPM Fusion)
-    void enableRepositories() {
-        logMessage("Sprawdzanie i włączanie repozytoriów...");
+    // Sprawdzenie, czy repozytoria RPM Fusion są już włączone
+    void checkRepositories() {
+        logMessage("Sprawdzanie repozytoriów...");
         
-        // Sprawdzenie, czy RPM Fusion jest już włączone
-        if (system("dnf repolist | grep -q rpmfusion") == 0) {
+        if (packages->isRepositoryEnabled("rpmfusion")) {
             logMessage("Repozytoria RPM Fusion są już włączone");
             rpmFusionEnabled = true;
+        }
+    }
+    
+    // Włączenie potrzebnych repozytoriów (RPM Fusion)
+    void enableRepositories() {
+        if (rpmFusionEnabled) {
             return;
         }
         
-        // Instalacja RPM Fusion Free
-        int resultFree = system("dnf install -y https://mirrors.rpmfusion.org/free/fedora/rpmfusion-free-release-$(rpm -E %fedora).noarch.rpm");
+        logMessage("Włączanie repozytoriów RPM Fusion...");
+        reportPhase("repositories", "Włączanie repozytoriów RPM Fusion");
         
-        // Instalacja RPM Fusion Non-free (potrzebne dla sterowników NVIDIA)
-        int resultNonfree = system("dnf install -y https://mirrors.rpmfusion.org/nonfree/fedora/rpmfusion-nonfree-release-$(rpm -E %fedora).noarch.rpm");
+        // RPM Fusion Free i Non-free (potrzebne dla sterowników NVIDIA) w jednej transakcji
+        std::vector<std::string> releasePackages;
+        if (offline) {
+            // Pliki z lokalnego repozytorium, instalowane tak jak z adresu URL (klucze RPM Fusion są w nich)
+            for (const char* name : {"rpmfusion-free-release-", "rpmfusion-nonfree-release-"}) {
+                std::string file = cachedPackageFile(name);
+                if (!file.empty()) {
+                    releasePackages.push_back(file);
+                }
+            }
+        } else {
+            std::string release = packages->releaseVersion();
+            if (!release.empty()) {
+                releasePackages = {
+                    "https://mirrors.rpmfusion.org/free/fedora/rpmfusion-free-release-" + release + ".noarch.rpm",
+                    "https://mirrors.rpmfusion.org/nonfree/fedora/rpmfusion-nonfree-release-" + release + ".noarch.rpm"
+                };
+            }
+        }
+        cancellation->setDeferred(true);
+        bool installed = releasePackages.size() == 2 && packages->install(releasePackages);
+        cancellation->setDeferred(false);
         
-        if (resultFree == 0 && resultNonfree == 0) {
+        recordTransaction("repositories");
+        
+        if (installed) {
             logMessage("Pomyślnie włączono repozytoria RPM Fusion");
             rpmFusionEnabled = true;
         } else {
-            logMessage("OSTRZEŻENIE: Nie udało się włączyć repozytoriów RPM Fusion");
+            logMessage("OSTRZEŻENIE: Nie udało się włączyć repozytoriów RPM Fusion", LogLevel::WARNING);
+        }
+    }
+    
+    // Najnowszy plik RPM w lokalnym repozytorium o nazwie zaczynającej się od prefiksu (pusty: brak)
+    std::string cachedPackageFile(const std::string& prefix) const {
+        std::string newest;
+        std::error_code error;
+        for (fs::directory_iterator it(cacheDir, error), end; !error && it != end; it.increment(error)) {
+            std::string name = it->path().filename().string();
+            if (name.compare(0, prefix.size(), prefix) == 0 && it->path().extension() == ".rpm" &&
+                it->path().string() > newest) {
+                newest = it->path().string();
+            }
         }
+        return newest;
     }
     
-    // Zapisywanie wiadomości do pliku logów
-    void logMessage(const std::string& message) {
-        // Wyświetlenie komunikatu na standardowe wyjście
-        std::cout << message << std::endl;
+    // Pakiety z listy, których nie ma w systemie
+    std::vector<std::string> missingPackages(const std::vector<std::string>& names) {
+        std::map<std::string, std::string> installed = packages->installedVersions(names);
+        std::vector<std::string> missing;
+        for (const auto& name : names) {
+            if (!installed.count(name)) {
+                missing.push_back(name);
+            }
+        }
+        return missing;
+    }
+    
+    // Pobranie pakietów planu instalacji w tle do lokalnego repozytorium
+    void startPrefetch() {
+        InstallSelection selection = selectInstallation(detectedDevices, selector, rpmFusionEnabled);
+        std::vector<std::string> names = seedCache ? selection.plan.packages() : missingPackages(selection.plan.packages());
         
-        // Zapisanie do pliku logów
-        std::ofstream log(logFile, std::ios_base::app);
-        if (log.is_open()) {
-            auto now = std::chrono::system_clock::now();
-            auto now_time_t = std::chrono::system_clock::to_time_t(now);
-            log << std::ctime(&now_time_t) << message << std::endl;
-            log.close();
+        // Repozytorium dla maszyn bez sieci zawiera też pakiety włączające RPM Fusion
+        bool rpmFusion = false;
+        for (size_t index : selection.plannedDevices) {
+            rpmFusion = rpmFusion || DriverSelector::requiresRpmFusion(detectedDevices[index].driverType);
+        }
+        if (seedCache && rpmFusion) {
+            names.push_back("rpmfusion-free-release");
+            names.push_back("rpmfusion-nonfree-release");
         }
+        if (names.empty()) {
+            return;
+        }
+        
+        logMessage("Pobieranie w tle " + std::to_string(names.size()) + " pakietów do " + cacheDir);
+        prefetchWorker = std::thread([this, names]() {
+            auto span = trace->span("prefetch");
+            span.setArg("packages", std::to_string(names.size()));
+            downloadProgress->reset();
+            auto onOutput = [this](const std::string& line) {
+                downloadProgress->feed(line);
+            };
+            prefetchSucceeded = packages->download(names, cacheDir, seedCache, onOutput) &&
+                                packages->createRepository(cacheDir);
+            span.setSuccess(prefetchSucceeded);
+        });
     }
     
-    // Wykonanie komendy systemowej i zwrócenie jej wyjścia
-    std::string executeCommand(const std::string& command) {
-        std::array<char, 128> buffer;
-        std::string result;
+    // Zapisanie w dzienniku zmian transakcji dnf wykonanych od ostatniego sprawdzenia historii.
+    // W tym czasie mogły działać też inne programy (PackageKit, dnf-automatic), a ich transakcji
+    // nie wolno wycofać. Własne polecenie dnf to pierwsza nowa transakcja, bo punkt odniesienia
+    // jest odczytywany tuż przed nim; transakcje akmods (backgroundCount) powstają w tle, więc
+    // należą do tego przebiegu tylko wtedy, gdy nowych jest dokładnie tyle, ile oczekiwano.
+    void recordTransaction(const std::string& scope, size_t backgroundCount = 0) {
+        std::string id = packages->lastTransactionId();
+        if (id.empty()) {
+            logMessage("OSTRZEŻENIE: Nie można odczytać historii transakcji dnf; zmiany pakietów nie zostaną wycofane", LogLevel::WARNING);
+            return;
+        }
         
-        // Wykonanie komendy i przechwycenie wyjścia
-        std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(command.c_str(), "r"), pclose);
-        if (!pipe) {
-            return "";
+        unsigned long latest = std::stoul(id);
+        unsigned long previous = lastTransaction.empty() ? 0 : std::stoul(lastTransaction);
+        lastTransaction = id;
+        
+        // Ten sam identyfikator: dnf nic nie zmienił (np. pakiety były już zainstalowane)
+        if (latest <= previous) {
+            return;
+        }
+        unsigned long count = latest - previous;
+        unsigned long own = backgroundCount ? backgroundCount : 1;
+        if (backgroundCount && count != backgroundCount) {
+            logMessage("OSTRZEŻENIE: W historii dnf jest " + std::to_string(count) + " nowych transakcji zamiast " +
+                       std::to_string(backgroundCount) + " (" + scope + "); nie zostaną wycofane automatycznie",
+                       LogLevel::WARNING);
+            return;
+        }
+        if (count > own) {
+            logMessage("OSTRZEŻENIE: Transakcje dnf " + std::to_string(previous + own + 1) + "-" + id +
+                       " nie należą do tego przebiegu i nie zostaną wycofane", LogLevel::WARNING);
+        }
+        if (journalStarted) {
+            for (unsigned long transaction = previous + 1; transaction <= previous + own; ++transaction) {
+                journal->recordTransaction(std::to_string(transaction), scope);
+            }
+        }
+    }
+    
+    // Zapis pliku konfiguracyjnego z wcześniejszym zapamiętaniem jego stanu w dzienniku zmian
+    bool writeConfigFile(const std::string& path, const std::string& contents) {
+        // Plik z tą samą zawartością nie jest zapisywany ani wpisywany do dziennika
+        std::error_code error;
+        if (fs::exists(path, error) && readFileContents(path) == contents) {
+            return true;
         }
         
-        while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
-            result += buffer.data();
+        if (!journal->recordFileChange(path)) {
+            logMessage("BŁĄD: Nie można zapisać w dzienniku zmian stanu pliku " + path, LogLevel::ERROR);
+            return false;
+        }
+        if (!writeFileAtomically(path, contents)) {
+            logMessage("BŁĄD: Nie można zapisać pliku " + path, LogLevel::ERROR);
+            return false;
+        }
+        logMessage("Zapisano plik konfiguracji " + path);
+        return true;
+    }
+    
+    // Usunięcie pliku konfiguracyjnego, który już nie obowiązuje; dziennik zmian pozwala go przywrócić
+    bool removeConfigFile(const std::string& path) {
+        std::error_code error;
+        if (!fs::exists(path, error)) {
+            return true;
         }
         
-        return result;
+        if (!journal->recordFileChange(path)) {
+            logMessage("BŁĄD: Nie można zapisać w dzienniku zmian stanu pliku " + path, LogLevel::ERROR);
+            return false;
+        }
+        if (!fs::remove(path, error)) {
+            logMessage("BŁĄD: Nie można usunąć pliku " + path, LogLevel::ERROR);
+            return false;
+        }
+        logMessage("Usunięto nieaktualny plik konfiguracji " + path);
+        return true;
+    }
+    
+    void reportStatus(const std::string& status) {
+        if (statusCallback) {
+            statusCallback(status);
+        }
+        ProgressEvent event;
+        event.event = "status";
+        event.phase = currentPhase;
+        event.message = status;
+        reportProgress(event);
+    }
+    
+    // Początek etapu: zdarzenie phase i nowy licznik postępu transakcji dnf
+    void reportPhase(const std::string& phase, const std::string& description) {
+        currentPhase = phase;
+        transactionProgress->reset();
+        ProgressEvent event;
+        event.event = "phase";
+        event.phase = phase;
+        event.message = description;
+        reportProgress(event);
+    }
+    
+    void reportProgress(const ProgressEvent& event) {
+        if (progressCallback) {
+            progressCallback(event);
+        }
+    }
+    
+    // Zapisywanie wiadomości do dziennika (zapis odbywa się w tle)
+    void logMessage(const std::string& message, LogLevel level = LogLevel::INFO) {
+        logger->log(level, message);
     }
 };
 
+// Połączenie gniazda postępu z menedżerem: zdarzenia instalacji do klientów, polecenie cancel do menedżera
+bool attachProgressServer(ProgressServer& server, DriverManager& driverManager) {
+    std::shared_ptr<Cancellation> cancellation = driverManager.cancellationToken();
+    bool started = server.start([cancellation](const std::string& command) {
+        if (command == "cancel") {
+            cancellation->cancel();
+        }
+    });
+    if (!started) {
+        std::cerr << "Ostrzeżenie: nie można utworzyć gniazda postępu " << server.socketPath()
+                  << " (działa inny instalator lub brak uprawnień)" << std::endl;
+        return false;
+    }
+    driverManager.setProgressCallback([&server](const ProgressEvent& event) {
+        server.publish(event);
+    });
+    return true;
+}
+
+// Wynik przebiegu dla klientów gniazda (interfejs graficzny kończy na nim okno postępu)
+void publishResult(ProgressServer& server, bool success, const std::string& message) {
+    ProgressEvent result;
+    result.event = "result";
+    result.success = success;
+    result.message = message;
+    server.publish(result);
+}
+
 // Klasa głównego programu
 class AutoDriverInstaller {
 private:
+    // Gniazdo przed menedżerem: niszczone po nim, bo pobieranie w tle publikuje zdarzenia do końca
+    ProgressServer progress;
     DriverManager driverManager;
-    
+    std::string input;               // Nieprzetworzone znaki ze standardowego wejścia
+    bool inputClosed = false;
+
 public:
+    explicit AutoDriverInstaller(const InstallerOptions& options) : progress(options.socketPath), driverManager(options) {
+    }
+    
+    
     // Uruchomienie instalacji sterowników
     int run() {
         std::cout << "===== Automatyczna instalacja sterowników graficznych Fedora =====" << std::endl;
@@ -432,9 +1329,20 @@ public:
         std::cout << "domyślne sterowniki." << std::endl;
         std::cout << std::endl;
         
+        // Postęp i przerwanie dla interfejsu graficznego (uruchomienie z pliku .desktop nie ma terminala)
+        attachProgressServer(progress, driverManager);
+        
         // Inicjalizacja
-        if (!driverManager.initialize()) {
+        bool initialized = driverManager.initialize();
+        driverManager.flushLog();
+        if (!initialized) {
+            if (driverManager.cancelled()) {
+                std::cout << "Instalacja została anulowana." << std::endl;
+                publishResult(progress, false, "Instalacja anulowana");
+                return 1;
+            }
             std::cerr << "Nie można kontynuować z powodu błędów inicjalizacji." << std::endl;
+            publishResult(progress, false, "Błąd inicjalizacji");
             return 1;
         }
         
@@ -447,78 +1355,233 @@ public:
         }
         
         // Pytanie o zgodę użytkownika
-        std::cout << "\nCzy chcesz kontynuować instalację zalecanych sterowników? (t/n): ";
-        std::string response;
-        std::getline(std::cin, response);
-        
-        if (response != "t" && response != "T") {
+        if (!ask("\nCzy chcesz kontynuować instalację zalecanych sterowników?")) {
             std::cout << "Instalacja została anulowana przez użytkownika." << std::endl;
+            publishResult(progress, false, "Instalacja anulowana przez użytkownika");
             return 0;
         }
         
         // Instalacja sterowników
         bool installSuccess = driverManager.installDrivers();
+        driverManager.flushLog();
         
         if (!installSuccess) {
-            std::cout << "\nWystąpiły problemy podczas instalacji sterowników." << std::endl;
-            std::cout << "Czy chcesz przywrócić domyślne sterowniki? (t/n): ";
-            std::getline(std::cin, response);
+            // Przerwana instalacja jest wycofywana bez pytania
+            if (driverManager.cancelled()) {
+                std::cout << "\nInstalacja została przerwana. Wycofywanie zmian..." << std::endl;
+                bool restored = driverManager.restoreDefaultDrivers();
+                driverManager.flushLog();
+                publishResult(progress, false, restored ? "Instalacja przerwana, zmiany wycofane"
+                                                        : "Instalacja przerwana, nie wszystkie zmiany wycofano");
+                return 1;
+            }
             
-            if (response == "t" || response == "T") {
+            std::cout << "\nWystąpiły problemy podczas instalacji sterowników." << std::endl;
+            if (ask("Czy chcesz przywrócić domyślne sterowniki?")) {
                 driverManager.restoreDefaultDrivers();
+                driverManager.flushLog();
                 std::cout << "Przywrócono domyślne sterowniki." << std::endl;
             }
             
+            publishResult(progress, false, "Wystąpiły problemy podczas instalacji sterowników");
             return 1;
         }
         
         // Testowanie sterowników
-        if (!driverManager.testDrivers()) {
+        bool testSuccess = driverManager.testDrivers();
+        driverManager.flushLog();
+        if (!testSuccess) {
             std::cout << "\nWystąpiły problemy z nowymi sterownikami." << std::endl;
             std::cout << "Przywracanie domyślnych sterowników..." << std::endl;
             
             driverManager.restoreDefaultDrivers();
+            publishResult(progress, false, "Problemy z nowymi sterownikami, zmiany wycofane");
             return 1;
         }
         
+        driverManager.saveFingerprint();
         std::cout << "\nInstalacja sterowników zakończona pomyślnie!" << std::endl;
         std::cout << "Zaleca się ponowne uruchomienie systemu, aby zmiany zostały w pełni zastosowane." << std::endl;
-        std::cout << "Czy chcesz teraz ponownie uruchomić system? (t/n): ";
-        std::getline(std::cin, response);
+        publishResult(progress, true, "Instalacja sterowników zakończona pomyślnie");
         
-        if (response == "t" || response == "T") {
-            system("reboot");
+        if (ask("Czy chcesz teraz ponownie uruchomić system?")) {
+            SystemCommandRunner().run({"reboot"});
         }
         
         return 0;
     }
+
+private:
+    // Pytanie t/n: odpowiedź z terminala albo confirm/decline z gniazda postępu, co przyjdzie
+    // pierwsze. Przerwanie instalacji i brak obu źródeł odpowiedzi oznaczają "nie".
+    bool ask(const std::string& question) {
+        ProgressEvent prompt;
+        prompt.event = "prompt";
+        prompt.message = question.substr(question.find_first_not_of('\n'));
+        progress.publish(prompt);
+        std::cout << question << " (t/n): " << std::flush;
+        
+        int cancelFd = driverManager.cancellationToken()->fd();
+        std::string answer;
+        bool answered = false;
+        while (!answered) {
+            // Pełna linia mogła zostać wczytana razem z poprzednią odpowiedzią
+            size_t newline = input.find('\n');
+            if (newline != std::string::npos) {
+                answer = input.substr(0, newline);
+                input.erase(0, newline + 1);
+                break;
+            }
+            
+            pollfd descriptors[3] = {
+                {inputClosed ? -1 : STDIN_FILENO, POLLIN, 0},
+                {progress.answerDescriptor(), POLLIN, 0},
+                {cancelFd, POLLIN, 0}
+            };
+            if (inputClosed && descriptors[1].fd < 0) {
+                break;
+            }
+            if (poll(descriptors, 3, -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            
+            if (descriptors[2].revents & POLLIN) {
+                std::cout << std::endl;
+                break;
+            }
+            if (descriptors[1].revents & POLLIN) {
+                std::string command = progress.takeAnswer();
+                if (!command.empty()) {
+                    answer = command == "confirm" ? "t" : "n";
+                    std::cout << answer << " (odpowiedź z interfejsu graficznego)" << std::endl;
+                    answered = true;
+                }
+            }
+            if (!answered && (descriptors[0].revents & (POLLIN | POLLHUP))) {
+                char buffer[256];
+                ssize_t size = read(STDIN_FILENO, buffer, sizeof(buffer));
+                if (size > 0) {
+                    input.append(buffer, static_cast<size_t>(size));
+                } else if (size == 0 || errno != EINTR) {
+                    // Bez terminala (np. z pliku .desktop) odpowiedź może przyjść już tylko z gniazda
+                    inputClosed = true;
+                }
+            }
+        }
+        
+        bool yes = answer == "t" || answer == "T";
+        ProgressEvent reply;
+        reply.event = "answer";
+        reply.message = yes ? "t" : "n";
+        progress.publish(reply);
+        return yes;
+    }
 };
 
-// Funkcja do tworzenia pliku usługi systemd
+// Funkcja do tworzenia pliku usługi systemd i reguły udev, która ją uruchamia
 void createSystemdService() {
     std::ofstream serviceFile("/etc/systemd/system/auto-driver-installer.service");
     if (serviceFile.is_open()) {
         serviceFile << "[Unit]\n";
         serviceFile << "Description=Automatic Graphics Driver Installer\n";
-        serviceFile << "After=network.target\n";
+        serviceFile << "Wants=network-online.target\n";
+        serviceFile << "After=network-online.target\n";
         serviceFile << "\n";
         serviceFile << "[Service]\n";
-        serviceFile << "Type=oneshot\n";
-        serviceFile << "ExecStart=/usr/bin/auto-driver-installer --auto\n";
-        serviceFile << "RemainAfterExit=yes\n";
-        serviceFile << "\n";
-        serviceFile << "[Install]\n";
-        serviceFile << "WantedBy=multi-user.target\n";
+        serviceFile << "Type=notify\n";
+        serviceFile << "NotifyAccess=main\n";
+        // SIGTERM dostaje tylko instalator i przerywa przebieg po zakończeniu transakcji dnf;
+        // SIGKILL dla całej grupy dopiero po TimeoutStopSec
+        serviceFile << "KillMode=mixed\n";
+        serviceFile << "TimeoutStopSec=10min\n";
+        serviceFile << "ExecStart=/usr/bin/auto-driver-installer --daemon --idle-timeout 300\n";
         serviceFile.close();
     }
+    
+    // Usługę uruchamia pojawienie się kontrolera wyświetlania (także przy starcie systemu)
+    std::ofstream ruleFile("/etc/udev/rules.d/90-auto-driver-installer.rules");
+    if (ruleFile.is_open()) {
+        ruleFile << "ACTION==\"add\", SUBSYSTEM==\"pci\", ATTR{class}==\"0x03*\", "
+                    "TAG+=\"systemd\", ENV{SYSTEMD_WANTS}+=\"auto-driver-installer.service\"\n";
+        ruleFile.close();
+    }
 }
 
-// Tryb automatyczny (bez interakcji z użytkownikiem)
-int runAutomatic() {
-    DriverManager driverManager;
+// Sygnał zatrzymania usługi (signalfd) jako żądanie przerwania przebiegu: transakcja dnf
+// kończy się normalnie, a zmiany są wycofywane jak po poleceniu cancel. Sygnał pozostaje
+// nieodczytany, więc pętla demona też go zobaczy i zakończy pracę.
+class StopSignalForwarder {
+private:
+    int doneFd = -1;
+    std::thread worker;
+
+public:
+    StopSignalForwarder(int stopFd, std::shared_ptr<Cancellation> cancellation) {
+        if (stopFd < 0) {
+            return;
+        }
+        doneFd = eventfd(0, EFD_CLOEXEC);
+        if (doneFd < 0) {
+            return;
+        }
+        int done = doneFd;
+        worker = std::thread([stopFd, done, cancellation]() {
+            pollfd descriptors[2] = {{stopFd, POLLIN, 0}, {done, POLLIN, 0}};
+            while (poll(descriptors, 2, -1) < 0 && errno == EINTR) {
+            }
+            if (descriptors[0].revents & POLLIN) {
+                cancellation->cancel();
+            }
+        });
+    }
+    
+    ~StopSignalForwarder() {
+        if (worker.joinable()) {
+            uint64_t value = 1;
+            ssize_t written = write(doneFd, &value, sizeof(value));
+            (void)written;
+            worker.join();
+        }
+        if (doneFd >= 0) {
+            close(doneFd);
+        }
+    }
+    
+    StopSignalForwarder(const StopSignalForwarder&) = delete;
+    StopSignalForwarder& operator=(const StopSignalForwarder&) = delete;
+};
+
+// Tryb automatyczny (bez interakcji z użytkownikiem); stopFd: sygnał zatrzymania usługi w --daemon
+int runAutomatic(const InstallerOptions& options, int stopFd = -1) {
+    SystemdNotifier notifier;
+    ProgressServer progress(options.socketPath);
+    DriverManager driverManager(options);
+    StopSignalForwarder stopForwarder(stopFd, driverManager.cancellationToken());
+    
+    // Szybka faza na ścieżce startu systemu: bez zmian od ostatniego udanego przebiegu nic nie robi
+    if (!options.force && !driverManager.hasPendingChanges()) {
+        notifier.ready("Sterowniki aktualne");
+        return 0;
+    }
+    
+    // Usługa jest gotowa, zanim zacznie się instalacja; reszta działa w tle z najniższym
+    // priorytetem i blokadą wyłączenia systemu w trakcie zmian pakietów
+    notifier.ready("Instalacja sterowników w tle");
+    driverManager.setStatusCallback([&notifier](const std::string& status) {
+        notifier.status(status);
+    });
+    attachProgressServer(progress, driverManager);
+    enterBackgroundPriority();
+    ShutdownInhibitor inhibitor("auto-driver-installer", "Instalacja sterowników graficznych");
     
     // Inicjalizacja
+    notifier.status("Wykrywanie kart, kopia zapasowa i repozytoria");
     if (!driverManager.initialize()) {
+        notifier.status("Błąd inicjalizacji");
+        publishResult(progress, false, driverManager.cancelled() ? "Instalacja anulowana" : "Błąd inicjalizacji");
         return 1;
     }
     
@@ -526,30 +1589,490 @@ int runAutomatic() {
     bool installSuccess = driverManager.installDrivers();
     
     // Testowanie sterowników
+    if (installSuccess) {
+        notifier.status("Testowanie sterowników");
+    }
     if (!installSuccess || !driverManager.testDrivers()) {
+        notifier.status("Wycofywanie zmian");
         driverManager.restoreDefaultDrivers();
+        notifier.status("Instalacja nie powiodła się, zmiany wycofane");
+        publishResult(progress, false, "Instalacja nie powiodła się, zmiany wycofane");
         return 1;
     }
     
+    driverManager.saveFingerprint();
+    notifier.status("Sterowniki zainstalowane");
+    publishResult(progress, true, "Sterowniki zainstalowane");
     return 0;
 }
 
+// Przygotowanie lokalnego repozytorium z pakietami dla kart tej maszyny, do instalacji
+// z --offline na maszynach o takim samym sprzęcie, ale bez sieci
+int runPrefetch(const InstallerOptions& options) {
+    DriverManager driverManager(options);
+    if (!driverManager.initialize()) {
+        driverManager.flushLog();
+        return 1;
+    }
+    
+    bool downloaded = driverManager.waitForPrefetch();
+    driverManager.flushLog();
+    if (!downloaded) {
+        std::cerr << "Nie udało się pobrać pakietów do " << options.cacheDir << std::endl;
+        return 1;
+    }
+    std::cout << "Lokalne repozytorium pakietów: " << options.cacheDir << std::endl;
+    return 0;
+}
+
+// Podgląd postępu instalacji z gniazda (--watch) lub samo przerwanie (--cancel). Ten sam
+// protokół wykorzystuje interfejs graficzny; odpowiedzi t/n z terminala trafiają do instalatora.
+int runWatch(const InstallerOptions& options) {
+    ProgressClient client;
+    if (!client.connect(options.socketPath)) {
+        std::cerr << "Nie można połączyć się z " << options.socketPath << " (instalator nie działa?)" << std::endl;
+        return 1;
+    }
+    if (options.mode == "--cancel") {
+        bool sent = client.send("cancel");
+        std::cout << (sent ? "Wysłano żądanie przerwania instalacji." : "Nie udało się wysłać żądania przerwania.")
+                  << std::endl;
+        return sent ? 0 : 1;
+    }
+    
+    // Ctrl+C przerywa instalację, a podgląd czeka na wynik wycofania zmian
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigprocmask(SIG_BLOCK, &signals, nullptr);
+    int signalFd = signalfd(-1, &signals, SFD_CLOEXEC | SFD_NONBLOCK);
+    
+    std::string input;
+    bool inputClosed = false;
+    bool cancelSent = false;
+    int status = 1;
+    bool finished = false;
+    while (!finished) {
+        pollfd descriptors[3] = {
+            {client.descriptor(), POLLIN, 0},
+            {inputClosed ? -1 : STDIN_FILENO, POLLIN, 0},
+            {signalFd, POLLIN, 0}
+        };
+        if (poll(descriptors, 3, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        
+        if (descriptors[2].revents & POLLIN) {
+            signalfd_siginfo info;
+            ssize_t size = read(signalFd, &info, sizeof(info));
+            (void)size;
+            if (!cancelSent) {
+                std::cout << "\nPrzerywanie instalacji..." << std::endl;
+                client.send("cancel");
+                cancelSent = true;
+            }
+        }
+        
+        if (descriptors[1].revents & (POLLIN | POLLHUP)) {
+            char buffer[256];
+            ssize_t size = read(STDIN_FILENO, buffer, sizeof(buffer));
+            if (size > 0) {
+                input.append(buffer, static_cast<size_t>(size));
+            } else if (size == 0 || errno != EINTR) {
+                inputClosed = true;
+            }
+            size_t newline;
+            while ((newline = input.find('\n')) != std::string::npos) {
+                std::string answer = input.substr(0, newline);
+                input.erase(0, newline + 1);
+                if (answer == "t" || answer == "T") {
+                    client.send("confirm");
+                } else if (answer == "n" || answer == "N") {
+                    client.send("decline");
+                }
+            }
+        }
+        
+        if (descriptors[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+            std::vector<std::string> events;
+            bool open = client.receive(events);
+            for (const auto& event : events) {
+                std::string type = jsonStringField(event, "event");
+                if (type == "prompt") {
+                    std::cout << ProgressClient::describe(event) << std::flush;
+                    continue;
+                }
+                std::cout << ProgressClient::describe(event) << std::endl;
+                if (type == "result") {
+                    status = event.find("\"success\":true") != std::string::npos ? 0 : 1;
+                    finished = true;
+                }
+            }
+            if (!open && !finished) {
+                std::cerr << "Instalator zakończył działanie bez podania wyniku" << std::endl;
+                break;
+            }
+        }
+    }
+    
+    if (signalFd >= 0) {
+        close(signalFd);
+    }
+    return status;
+}
+
+// Tryb usługi: przebieg dla kart obecnych przy starcie, potem instalacja tylko dla kart
+// podłączonych później (eGPU, stacje dokujące) po zdarzeniach jądra
+int runDaemon(const InstallerOptions& options) {
+    // SIGTERM od systemd kończy oczekiwanie na zdarzenia, a w trakcie przebiegu działa jak cancel:
+    // trwająca transakcja dnf kończy się (KillMode=mixed), po czym zmiany są wycofywane
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGINT);
+    sigprocmask(SIG_BLOCK, &signals, nullptr);
+    int stopFd = signalfd(-1, &signals, SFD_CLOEXEC | SFD_NONBLOCK);
+    
+    // Subskrypcja przed pierwszym przebiegiem, żeby nie zgubić zdarzeń z jego czasu
+    UeventMonitor monitor;
+    if (!monitor.open()) {
+        std::cerr << "Nie można otworzyć gniazda zdarzeń jądra (NETLINK_KOBJECT_UEVENT)" << std::endl;
+        return 1;
+    }
+    
+    int status = runAutomatic(options, stopFd);
+    InstallerOptions hotplugOptions = options;
+    hotplugOptions.force = false;
+    
+    // Odcisk systemu ogranicza każdy kolejny przebieg do kart, które się pojawiły
+    SystemdNotifier notifier;
+    while (true) {
+        notifier.status("Oczekiwanie na nowe karty graficzne");
+        std::vector<std::string> slots;
+        UeventWaitResult result = monitor.waitForDisplayDevices(options.debounce, std::chrono::seconds(10),
+                                                                options.idleTimeout, stopFd, slots);
+        if (result == UeventWaitResult::FAILED) {
+            std::cerr << "Błąd odczytu zdarzeń jądra" << std::endl;
+            status = 1;
+            break;
+        }
+        if (result != UeventWaitResult::DEVICES) {
+            break;
+        }
+        
+        std::string list;
+        for (const auto& slot : slots) {
+            list += (list.empty() ? "" : ", ") + slot;
+        }
+        std::cout << "Nowe kontrolery wyświetlania: " << list << std::endl;
+        status = runAutomatic(hotplugOptions, stopFd);
+    }
+    
+    if (stopFd >= 0) {
+        close(stopFd);
+    }
+    return status;
+}
+
+// Pomiar czasu wykonania fazy w milisekundach
+template <typename Phase>
+double measurePhase(Phase&& phase, bool& result) {
+    auto start = std::chrono::steady_clock::now();
+    result = phase();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Benchmark przebiegu automatycznego na drzewach testowych z symulowanym menedżerem pakietów
+int runBenchmark(const InstallerOptions& options) {
+    std::string workspace = options.benchmarkDir;
+    if (workspace.empty()) {
+        char pattern[] = "/tmp/driver-installer-benchmark.XXXXXX";
+        if (!mkdtemp(pattern)) {
+            std::cerr << "Nie można utworzyć katalogu roboczego benchmarku" << std::endl;
+            return 1;
+        }
+        workspace = pattern;
+    }
+    
+    std::string kernelRelease = KmodWaiter::runningKernelRelease();
+    
+    std::printf("%-26s %10s %10s %10s %10s %10s %10s\n", "Scenariusz", "init [ms]", "instal.", "test", "przywr.", "razem",
+                "powt.");
+    
+    for (const auto& fixture : standardHardwareFixtures()) {
+        std::string root = workspace + "/" + fixture.name;
+        if (!writeHardwareFixture(root, fixture, kernelRelease)) {
+            std::cerr << "Nie można utworzyć drzewa testowego: " << root << std::endl;
+            return 1;
+        }
+        
+        InstallerOptions fixtureOptions;
+        fixtureOptions.sysfsRoot = root + "/sys";
+        fixtureOptions.procRoot = root + "/proc";
+        fixtureOptions.modulesRoot = root + "/lib/modules";
+        fixtureOptions.stateDir = root + "/var/lib/driver-installer";
+        fixtureOptions.x11Dir = root + "/etc/X11";
+        fixtureOptions.modprobeDir = root + "/etc/modprobe.d";
+        fixtureOptions.udevRulesDir = root + "/etc/udev/rules.d";
+        fixtureOptions.cacheDir = root + "/var/cache/auto-driver-installer";
+        fixtureOptions.pciDatabase = options.pciDatabase;
+        fixtureOptions.rpmDatabase = root + "/var/lib/rpm/rpmdb.sqlite";
+        fixtureOptions.kmodTimeout = std::chrono::seconds(5);
+        fixtureOptions.requireRoot = false;
+        
+        // Komunikaty faz trafiają do install.log w drzewie testowym, a nie na ekran
+        fixtureOptions.logToConsole = false;
+        
+        // Model opóźnień zbliżony proporcjami do rzeczywistego dnf
+        auto runner = std::make_shared<SimulatedCommandRunner>();
+        runner->setLatency("lsmod", std::chrono::milliseconds(5));
+        runner->setLatency("akmods", std::chrono::milliseconds(400));
+        
+        auto packages = std::make_shared<SimulatedPackageBackend>();
+        // Repozytoria, wydanie i zainstalowane pakiety: odczyt plików .repo, os-release i bazy rpm w procesie
+        packages->setLatency("repolist", std::chrono::milliseconds(2));
+        packages->setLatency("release", std::chrono::milliseconds(1));
+        packages->setLatency("install", std::chrono::milliseconds(600));
+        packages->setLatency("remove", std::chrono::milliseconds(300));
+        packages->setLatency("reinstall", std::chrono::milliseconds(500));
+        packages->setLatency("history", std::chrono::milliseconds(150));
+        packages->setLatency("undo", std::chrono::milliseconds(500));
+        packages->setLatency("rollback", std::chrono::milliseconds(500));
+        packages->setLatency("query", std::chrono::milliseconds(5));
+        packages->setLatency("download", std::chrono::milliseconds(50));
+        packages->setLatency("createrepo", std::chrono::milliseconds(30));
+        packages->setPerPackageLatency(std::chrono::milliseconds(15));
+        packages->setDownloadLatency(std::chrono::milliseconds(25));
+        if (fixture.failNvidiaInstall) {
+            packages->failPackage("akmod-nvidia");
+        }
+        
+        bool initialized = false, installed = false, tested = false, restored = false;
+        double initTime = 0, installTime = 0, testTime = 0, restoreTime = 0;
+        {
+            // Przebieg kończy się przed kolejnym uruchomieniem (dziennik zmian, metryki)
+            DriverManager driverManager(fixtureOptions, runner, packages);
+            initTime = measurePhase([&]() { return driverManager.initialize(); }, initialized);
+            if (initialized) {
+                installTime = measurePhase([&]() { return driverManager.installDrivers(); }, installed);
+                if (installed) {
+                    testTime = measurePhase([&]() { return driverManager.testDrivers(); }, tested);
+                }
+                if (!installed || !tested) {
+                    restoreTime = measurePhase([&]() { return driverManager.restoreDefaultDrivers(); }, restored);
+                } else {
+                    driverManager.saveFingerprint();
+                }
+            }
+        }
+        
+        // Kolejne uruchomienie systemu bez zmian sprzętu: szybka ścieżka --auto
+        bool pending = false;
+        double repeatTime = measurePhase([&]() {
+            return DriverManager(fixtureOptions, runner, packages).hasPendingChanges();
+        }, pending);
+        
+        std::printf("%-26s %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n", fixture.name.c_str(), initTime, installTime,
+                    testTime, restoreTime, initTime + installTime + testTime + restoreTime, repeatTime);
+    }
+    
+    std::cout << "\nDrzewa testowe i logi: " << workspace << std::endl;
+    return 0;
+}
+
+// Planowanie instalacji dla inwentarza migawek sprzętu (bez roota i bez zmian w systemie)
+int runPlan(const InstallerOptions& options) {
+    auto database = std::make_shared<PciDriverDatabase>();
+    if (!database->open(options.pciDatabase)) {
+        std::cerr << "Ostrzeżenie: nie można otworzyć bazy sterowników " << options.pciDatabase
+                  << ", używane są domyślne sterowniki producentów" << std::endl;
+        database.reset();
+    }
+    DriverSelector selector(database);
+    
+    // Nazwy modeli z pci.ids; bez hwdata zostają opisy z migawek lspci
+    PciNames names;
+    names.load(options.pciIds);
+    
+    unsigned int cores = std::thread::hardware_concurrency();
+    size_t threads = options.jobs ? options.jobs : (cores == 0 ? 2u : cores);
+    FleetPlanner planner(selector, options.planOutputDir, threads, &names);
+    FleetSummary summary = planner.run(options.planDir);
+    
+    std::printf("Maszyny: %zu (nieczytelne: %zu), czas: %.2f s, wątki: %zu\n", summary.machines, summary.failed,
+                summary.seconds, threads);
+    std::vector<std::pair<std::string, size_t>> packages(summary.packageHistogram.begin(), summary.packageHistogram.end());
+    std::sort(packages.begin(), packages.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    for (const auto& package : packages) {
+        std::printf("%8zu  %s\n", package.second, package.first.c_str());
+    }
+    std::cout << "\nPlany instalacji: " << options.planOutputDir << std::endl;
+    return summary.machines == 0 ? 1 : 0;
+}
+
+// Parsowanie argumentów wiersza poleceń
+bool parseOptions(int argc, char* argv[], InstallerOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        
+        if (arg == "--auto" || arg == "--daemon" || arg == "--install-service" || arg == "--prefetch") {
+            options.mode = arg;
+        } else if (arg == "--watch" || arg == "--cancel") {
+            options.mode = arg;
+        } else if (arg == "--socket" && i + 1 < argc) {
+            options.socketPath = argv[++i];
+        } else if (arg == "--list-backups") {
+            options.mode = arg;
+        } else if (arg == "--rollback") {
+            options.mode = arg;
+        } else if (arg == "--restore-backup") {
+            options.mode = arg;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                options.backupGeneration = argv[++i];
+            }
+        } else if (arg == "--benchmark") {
+            options.mode = arg;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                options.benchmarkDir = argv[++i];
+            }
+        } else if (arg == "--plan" && i + 1 < argc) {
+            options.mode = arg;
+            options.planDir = argv[++i];
+        } else if (arg == "--plan-output" && i + 1 < argc) {
+            options.planOutputDir = argv[++i];
+        } else if (arg == "--debounce" && i + 1 < argc) {
+            options.debounce = std::chrono::milliseconds(std::atoi(argv[++i]));
+        } else if (arg == "--idle-timeout" && i + 1 < argc) {
+            options.idleTimeout = std::chrono::seconds(std::atoi(argv[++i]));
+        } else if (arg == "--offline") {
+            options.offline = true;
+        } else if (arg == "--cache-dir" && i + 1 < argc) {
+            options.cacheDir = argv[++i];
+        } else if (arg == "--force") {
+            options.force = true;
+        } else if (arg == "--rpm-db" && i + 1 < argc) {
+            options.rpmDatabase = argv[++i];
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            options.jobs = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (arg == "--journal") {
+            options.logToJournal = true;
+        } else if (arg == "--state-dir" && i + 1 < argc) {
+            options.stateDir = argv[++i];
+        } else if (arg == "--pci-db" && i + 1 < argc) {
+            options.pciDatabase = argv[++i];
+        } else if (arg == "--pci-ids" && i + 1 < argc) {
+            options.pciIds = argv[++i];
+        } else if (arg == "--sysfs-root" && i + 1 < argc) {
+            options.sysfsRoot = argv[++i];
+        } else if (arg == "--proc-root" && i + 1 < argc) {
+            options.procRoot = argv[++i];
+        } else if (arg == "--command-timeout" && i + 1 < argc) {
+            options.commandTimeout = std::chrono::seconds(std::atoi(argv[++i]));
+        } else if (arg == "--health-budget" && i + 1 < argc) {
+            options.healthBudget = std::chrono::milliseconds(std::atoi(argv[++i]));
+        } else if (arg == "--display-servers" && i + 1 < argc) {
+            std::istringstream names(argv[++i]);
+            std::string name;
+            while (std::getline(names, name, ',')) {
+                if (!name.empty()) {
+                    options.displayServers.push_back(name);
+                }
+            }
+        } else if (arg == "--kmod-timeout" && i + 1 < argc) {
+            options.kmodTimeout = std::chrono::seconds(std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Nieznana opcja: " << arg << std::endl;
+            return false;
+        }
+    }
+    
+    return true;
+}
+
 // Główna funkcja programu
 int main(int argc, char* argv[]) {
+    InstallerOptions options;
+    
+    // Pod systemd standardowe wyjście i tak trafia do journald; protokół natywny zachowuje poziom ważności
+    if (Logger::stderrIsJournal()) {
+        options.logToJournal = true;
+    }
+    
+    if (!parseOptions(argc, argv, options)) {
+        return 2;
+    }
+    
     // Sprawdzenie, czy uruchomiono w trybie automatycznym
-    if (argc > 1 && std::string(argv[1]) == "--auto") {
-        return runAutomatic();
+    if (options.mode == "--auto") {
+        return runAutomatic(options);
+    }
+    
+    // Usługa uruchamiana przez regułę udev
+    if (options.mode == "--daemon") {
+        return runDaemon(options);
+    }
+    
+    // Repozytorium pakietów dla instalacji bez sieci
+    if (options.mode == "--prefetch") {
+        return runPrefetch(options);
+    }
+    
+    // Podgląd postępu i przerwanie instalacji przez gniazdo (bez roota dla członków grupy wheel)
+    if (options.mode == "--watch" || options.mode == "--cancel") {
+        return runWatch(options);
+    }
+    
+    // Pomiar czasu faz na symulowanym systemie (bez roota i bez zmian w systemie)
+    if (options.mode == "--benchmark") {
+        return runBenchmark(options);
+    }
+    
+    // Plany instalacji dla migawek sprzętu
+    if (options.mode == "--plan") {
+        return runPlan(options);
+    }
+    
+    // Lista generacji kopii zapasowych
+    if (options.mode == "--list-backups") {
+        DriverManager driverManager(options);
+        for (const auto& generation : driverManager.listBackups()) {
+            std::cout << generation << std::endl;
+        }
+        return 0;
+    }
+    
+    // Przywrócenie konfiguracji z wybranej generacji (bez zmian w pakietach)
+    if (options.mode == "--restore-backup") {
+        DriverManager driverManager(options);
+        return driverManager.restoreBackup(options.backupGeneration) ? 0 : 1;
+    }
+    
+    // Wycofanie zmian zapisanych w dzienniku ostatniego przebiegu (np. po awarii w trakcie instalacji)
+    if (options.mode == "--rollback") {
+        DriverManager driverManager(options);
+        return driverManager.restoreDefaultDrivers() ? 0 : 1;
     }
     
     // Sprawdzenie, czy uruchomiono z opcją instalacji usługi
-    if (argc > 1 && std::string(argv[1]) == "--install-service") {
+    if (options.mode == "--install-service") {
         createSystemdService();
-        system("systemctl enable auto-driver-installer.service");
-        std::cout << "Usługa automatycznej instalacji sterowników została zainstalowana i włączona." << std::endl;
+        SystemCommandRunner runner;
+        runner.run({"systemctl", "daemon-reload"});
+        runner.run({"udevadm", "control", "--reload"});
+        
+        // Karty obecne już teraz: ponowne zdarzenie add dla kontrolerów wyświetlania
+        runner.run({"udevadm", "trigger", "--action=add", "--subsystem-match=pci", "--attr-match=class=0x03*"});
+        std::cout << "Usługa automatycznej instalacji sterowników została zainstalowana (uruchamia ją reguła udev)." << std::endl;
         return 0;
     }
     
     // Uruchomienie w trybie interaktywnym
-    AutoDriverInstaller installer;
+    AutoDriverInstaller installer(options);
     return installer.run();
-}
\ No newline at end of file
+}
@@ -0,0 +1,467 @@
+#include "backup-store.h"
+#include "file-utils.h"
+#include "sha256.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <set>
+#include <sstream>
+#include <utility>
+
+// Dla FICLONE i operacji na deskryptorach
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* manifestHeader = "# auto-driver-installer backup manifest v1\n";
+
+// Kopia zawartości: najpierw reflink (FICLONE), a gdy system plików go nie obsługuje, zwykłe kopiowanie
+bool cloneOrCopy(int sourceFd, int targetFd) {
+    if (ioctl(targetFd, FICLONE, sourceFd) == 0) {
+        return true;
+    }
+    
+    if (lseek(sourceFd, 0, SEEK_SET) < 0) {
+        return false;
+    }
+    char buffer[64 * 1024];
+    ssize_t count;
+    while ((count = read(sourceFd, buffer, sizeof(buffer))) > 0) {
+        ssize_t offset = 0;
+        while (offset < count) {
+            ssize_t written = write(targetFd, buffer + offset, static_cast<size_t>(count - offset));
+            if (written <= 0) {
+                return false;
+            }
+            offset += written;
+        }
+    }
+    return count == 0;
+}
+
+int64_t modificationNanos(const struct stat& info) {
+    return static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+}
+
+}
+
+BackupStore::BackupStore(std::string directory, size_t maxGenerations)
+    : directory(std::move(directory)), maxGenerations(std::max<size_t>(1, maxGenerations)) {
+}
+
+SnapshotResult BackupStore::snapshot(const std::vector<std::string>& roots,
+                                     const std::map<std::string, std::string>& extraContents) {
+    SnapshotResult result;
+    std::error_code error;
+    fs::create_directories(directory + "/objects", error);
+    fs::create_directories(directory + "/generations", error);
+    
+    // Metadane z ostatniej generacji pozwalają pominąć odczyt niezmienionych plików
+    BackupGeneration previous;
+    std::map<std::string, const BackupEntry*> previousEntries;
+    std::string latest = latestGeneration();
+    if (!latest.empty() && loadGeneration(latest, previous)) {
+        for (const auto& entry : previous.entries) {
+            previousEntries[entry.path] = &entry;
+        }
+    }
+    
+    BackupGeneration generation;
+    auto addFile = [&](const std::string& path) -> bool {
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+            return true;
+        }
+        
+        BackupEntry entry;
+        entry.path = path;
+        entry.mode = info.st_mode & 07777;
+        entry.size = static_cast<uint64_t>(info.st_size);
+        entry.mtimeNanos = modificationNanos(info);
+        entry.inode = static_cast<uint64_t>(info.st_ino);
+        
+        auto it = previousEntries.find(path);
+        if (it != previousEntries.end() && it->second->size == entry.size && it->second->mtimeNanos == entry.mtimeNanos &&
+            it->second->inode == entry.inode && access(objectPath(it->second->hash).c_str(), F_OK) == 0) {
+            entry.hash = it->second->hash;
+            ++result.filesReused;
+        } else {
+            if (!storeObject(path, entry.hash, result.objectsStored)) {
+                return false;
+            }
+            ++result.filesHashed;
+        }
+        
+        generation.entries.push_back(entry);
+        return true;
+    };
+    
+    for (const auto& root : roots) {
+        BackupRoot backupRoot;
+        backupRoot.path = root;
+        
+        struct stat info;
+        if (stat(root.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+            backupRoot.type = 'd';
+            std::vector<std::string> files;
+            for (fs::recursive_directory_iterator it(root, error), end; !error && it != end; it.increment(error)) {
+                if (it->is_regular_file(error) && !it->is_symlink(error)) {
+                    files.push_back(it->path().string());
+                }
+            }
+            std::sort(files.begin(), files.end());
+            for (const auto& file : files) {
+                if (!addFile(file)) {
+                    return result;
+                }
+            }
+        } else if (stat(root.c_str(), &info) == 0) {
+            backupRoot.type = 'f';
+            if (!addFile(root)) {
+                return result;
+            }
+        }
+        generation.roots.push_back(backupRoot);
+    }
+    
+    for (const auto& extra : extraContents) {
+        BackupEntry entry;
+        entry.path = extra.first;
+        entry.size = extra.second.size();
+        if (!storeContents(extra.second, entry.hash, result.objectsStored)) {
+            return result;
+        }
+        generation.entries.push_back(entry);
+    }
+    
+    // Ten sam stan co w ostatniej generacji: nic do zapisania
+    if (!latest.empty() && formatManifest(generation) == formatManifest(previous)) {
+        result.success = true;
+        result.generation = latest;
+        return result;
+    }
+    
+    char stamp[32];
+    std::time_t now = std::time(nullptr);
+    std::tm local;
+    localtime_r(&now, &local);
+    std::strftime(stamp, sizeof(stamp), "%Y%m%dT%H%M%S", &local);
+    
+    std::string id = stamp;
+    for (int suffix = 2; fs::exists(directory + "/generations/" + id, error); ++suffix) {
+        id = std::string(stamp) + "-" + std::to_string(suffix);
+    }
+    generation.id = id;
+    
+    std::string generationDir = directory + "/generations/" + id;
+    fs::create_directories(generationDir, error);
+    if (!writeFileAtomically(generationDir + "/manifest", formatManifest(generation))) {
+        return result;
+    }
+    writeFileAtomically(directory + "/latest", id + "\n");
+    
+    prune();
+    
+    result.success = true;
+    result.generation = id;
+    result.created = true;
+    return result;
+}
+
+std::vector<std::string> BackupStore::generations() const {
+    std::vector<std::string> ids;
+    std::error_code error;
+    for (fs::directory_iterator it(directory + "/generations", error), end; !error && it != end; it.increment(error)) {
+        if (fs::exists(it->path() / "manifest", error)) {
+            ids.push_back(it->path().filename().string());
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+std::string BackupStore::latestGeneration() const {
+    std::string latest = readFirstLine(directory + "/latest");
+    if (!latest.empty() && access((directory + "/generations/" + latest + "/manifest").c_str(), F_OK) == 0) {
+        return latest;
+    }
+    
+    std::vector<std::string> ids = generations();
+    return ids.empty() ? "" : ids.back();
+}
+
+bool BackupStore::loadGeneration(const std::string& id, BackupGeneration& generation) const {
+    std::string text = readFileContents(directory + "/generations/" + id + "/manifest");
+    if (text.empty()) {
+        return false;
+    }
+    generation = BackupGeneration();
+    generation.id = id;
+    return parseManifest(text, generation);
+}
+
+bool BackupStore::restore(const std::string& id, std::vector<std::string>* restoredPaths) {
+    BackupGeneration generation;
+    if (!loadGeneration(id, generation)) {
+        return false;
+    }
+    
+    bool success = true;
+    std::error_code error;
+    
+    auto restoreEntry = [&](const BackupEntry& entry) {
+        if (!copyObjectTo(entry.hash, entry.path, entry.mode)) {
+            success = false;
+        } else if (restoredPaths) {
+            restoredPaths->push_back(entry.path);
+        }
+    };
+    
+    for (const auto& root : generation.roots) {
+        if (root.type == 'f') {
+            for (const auto& entry : generation.entries) {
+                if (entry.path == root.path) {
+                    restoreEntry(entry);
+                }
+            }
+        } else if (root.type == 'd') {
+            fs::create_directories(root.path, error);
+            std::set<std::string> expected;
+            const std::string prefix = root.path + "/";
+            for (const auto& entry : generation.entries) {
+                if (entry.path.compare(0, prefix.size(), prefix) == 0) {
+                    fs::create_directories(fs::path(entry.path).parent_path(), error);
+                    restoreEntry(entry);
+                    expected.insert(entry.path);
+                }
+            }
+            
+            // Pliki, których nie było w chwili wykonania kopii (np. dopisane przez instalator)
+            std::vector<std::string> added;
+            for (fs::recursive_directory_iterator it(root.path, error), end; !error && it != end; it.increment(error)) {
+                if (it->is_regular_file(error) && !expected.count(it->path().string())) {
+                    added.push_back(it->path().string());
+                }
+            }
+            for (const auto& path : added) {
+                fs::remove(path, error);
+                if (restoredPaths) {
+                    restoredPaths->push_back(path);
+                }
+            }
+        } else if (fs::is_regular_file(root.path, error)) {
+            // Pliku nie było przed zmianami (np. wygenerowany plik xorg.conf.d)
+            fs::remove(root.path, error);
+            if (restoredPaths) {
+                restoredPaths->push_back(root.path);
+            }
+        }
+    }
+    
+    return success;
+}
+
+bool BackupStore::readObject(const std::string& hash, std::string& contents) const {
+    std::string path = objectPath(hash);
+    if (access(path.c_str(), R_OK) != 0) {
+        return false;
+    }
+    contents = readFileContents(path);
+    return true;
+}
+
+std::string BackupStore::objectPath(const std::string& hash) const {
+    if (hash.size() < 3) {
+        return directory + "/objects/invalid";
+    }
+    return directory + "/objects/" + hash.substr(0, 2) + "/" + hash.substr(2);
+}
+
+bool BackupStore::storeFile(const std::string& path, std::string& hash) {
+    size_t stored = 0;
+    return storeObject(path, hash, stored);
+}
+
+bool BackupStore::restoreObject(const std::string& hash, const std::string& target, unsigned mode) {
+    return copyObjectTo(hash, target, mode);
+}
+
+bool BackupStore::storeObject(const std::string& sourcePath, std::string& hash, size_t& stored) {
+    int sourceFd = open(sourcePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (sourceFd < 0) {
+        return false;
+    }
+    
+    Sha256 sha;
+    char buffer[64 * 1024];
+    ssize_t count;
+    while ((count = read(sourceFd, buffer, sizeof(buffer))) > 0) {
+        sha.update(buffer, static_cast<size_t>(count));
+    }
+    if (count < 0) {
+        close(sourceFd);
+        return false;
+    }
+    hash = sha.hexDigest();
+    
+    std::string target = objectPath(hash);
+    if (access(target.c_str(), F_OK) == 0) {
+        close(sourceFd);
+        return true;
+    }
+    
+    std::error_code error;
+    fs::create_directories(fs::path(target).parent_path(), error);
+    std::string temporary = target + ".tmp." + std::to_string(getpid());
+    int targetFd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (targetFd < 0) {
+        close(sourceFd);
+        return false;
+    }
+    
+    bool copied = cloneOrCopy(sourceFd, targetFd) && fsync(targetFd) == 0;
+    close(sourceFd);
+    close(targetFd);
+    if (!copied || rename(temporary.c_str(), target.c_str()) != 0) {
+        unlink(temporary.c_str());
+        return false;
+    }
+    
+    ++stored;
+    return true;
+}
+
+bool BackupStore::storeContents(const std::string& contents, std::string& hash, size_t& stored) {
+    hash = Sha256::hash(contents);
+    std::string target = objectPath(hash);
+    if (access(target.c_str(), F_OK) == 0) {
+        return true;
+    }
+    
+    std::error_code error;
+    fs::create_directories(fs::path(target).parent_path(), error);
+    if (!writeFileAtomically(target, contents)) {
+        return false;
+    }
+    ++stored;
+    return true;
+}
+
+bool BackupStore::copyObjectTo(const std::string& hash, const std::string& target, unsigned mode) {
+    int sourceFd = open(objectPath(hash).c_str(), O_RDONLY | O_CLOEXEC);
+    if (sourceFd < 0) {
+        return false;
+    }
+    
+    // Plik tymczasowy w katalogu docelowym, aby rename był atomowy
+    fs::path targetPath(target);
+    std::string pattern = (targetPath.parent_path() / ("." + targetPath.filename().string() + ".restore-XXXXXX")).string();
+    std::vector<char> temporary(pattern.begin(), pattern.end());
+    temporary.push_back('\0');
+    int targetFd = mkostemp(temporary.data(), O_CLOEXEC);
+    if (targetFd < 0) {
+        close(sourceFd);
+        return false;
+    }
+    
+    bool copied = cloneOrCopy(sourceFd, targetFd) && fchmod(targetFd, mode) == 0 && fsync(targetFd) == 0;
+    close(sourceFd);
+    close(targetFd);
+    if (!copied || rename(temporary.data(), target.c_str()) != 0) {
+        unlink(temporary.data());
+        return false;
+    }
+    return true;
+}
+
+std::string BackupStore::formatManifest(const BackupGeneration& generation) const {
+    std::ostringstream text;
+    text << manifestHeader;
+    for (const auto& root : generation.roots) {
+        text << "root\t" << root.type << "\t" << root.path << "\n";
+    }
+    for (const auto& entry : generation.entries) {
+        char mode[8];
+        std::snprintf(mode, sizeof(mode), "%04o", entry.mode);
+        text << "file\t" << entry.hash << "\t" << mode << "\t" << entry.size << "\t" << entry.mtimeNanos
+             << "\t" << entry.inode << "\t" << entry.path << "\n";
+    }
+    return text.str();
+}
+
+bool BackupStore::parseManifest(const std::string& text, BackupGeneration& generation) const {
+    std::istringstream stream(text);
+    std::string line;
+    while (std::getline(stream, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        
+        std::vector<std::string> fields;
+        size_t start = 0;
+        size_t tab;
+        // Ścieżka jest ostatnim polem i może zawierać dowolne znaki poza tabulacją i nową linią
+        while ((tab = line.find('\t', start)) != std::string::npos) {
+            fields.push_back(line.substr(start, tab - start));
+            start = tab + 1;
+        }
+        fields.push_back(line.substr(start));
+        
+        if (fields[0] == "root" && fields.size() == 3 && fields[1].size() == 1) {
+            generation.roots.push_back({fields[2], fields[1][0]});
+        } else if (fields[0] == "file" && fields.size() == 7) {
+            BackupEntry entry;
+            entry.hash = fields[1];
+            entry.mode = static_cast<unsigned>(std::stoul(fields[2], nullptr, 8));
+            entry.size = std::stoull(fields[3]);
+            entry.mtimeNanos = std::stoll(fields[4]);
+            entry.inode = std::stoull(fields[5]);
+            entry.path = fields[6];
+            generation.entries.push_back(entry);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BackupStore::prune() {
+    std::vector<std::string> ids = generations();
+    if (ids.size() <= maxGenerations) {
+        return;
+    }
+    
+    std::error_code error;
+    for (size_t i = 0; i + maxGenerations < ids.size(); ++i) {
+        fs::remove_all(directory + "/generations/" + ids[i], error);
+    }
+    
+    // Usunięcie obiektów, do których nie odwołuje się żadna pozostała generacja
+    std::set<std::string> referenced;
+    for (const auto& id : generations()) {
+        BackupGeneration generation;
+        if (loadGeneration(id, generation)) {
+            for (const auto& entry : generation.entries) {
+                referenced.insert(objectPath(entry.hash));
+            }
+        }
+    }
+    
+    std::vector<fs::path> unreferenced;
+    for (fs::recursive_directory_iterator it(directory + "/objects", error), end; !error && it != end; it.increment(error)) {
+        if (it->is_regular_file(error) && !referenced.count(it->path().string())) {
+            unreferenced.push_back(it->path());
+        }
+    }
+    for (const auto& path : unreferenced) {
+        fs::remove(path, error);
+    }
+}
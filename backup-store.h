@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Plik zapisany w generacji kopii zapasowej
+struct BackupEntry {
+    std::string path;         // Ścieżka bezwzględna lub nazwa migawki zaczynająca się od @
+    std::string hash;         // SHA-256 zawartości (nazwa obiektu w magazynie)
+    unsigned mode = 0644;     // Uprawnienia pliku
+    uint64_t size = 0;
+    int64_t mtimeNanos = 0;   // Czas modyfikacji (do pominięcia ponownego liczenia skrótu)
+    uint64_t inode = 0;
+};
+
+// Ścieżka objęta kopią i jej stan w chwili wykonania kopii
+struct BackupRoot {
+    std::string path;
+    char type = '-';          // 'f' plik, 'd' katalog, '-' nie istniała
+};
+
+// Jedna generacja kopii zapasowej (manifest)
+struct BackupGeneration {
+    std::string id;
+    std::vector<BackupRoot> roots;
+    std::vector<BackupEntry> entries;
+};
+
+// Wynik wykonania migawki
+struct SnapshotResult {
+    bool success = false;
+    std::string generation;   // Generacja odpowiadająca bieżącemu stanowi
+    bool created = false;     // false: stan niezmieniony, wykorzystano ostatnią generację
+    size_t filesHashed = 0;   // Pliki, których zawartość trzeba było odczytać
+    size_t filesReused = 0;   // Pliki z niezmienionymi metadanymi (bez odczytu)
+    size_t objectsStored = 0; // Nowe obiekty w magazynie
+};
+
+// Magazyn kopii zapasowych adresowany treścią: obiekty objects/<skrót>, generacje
+// generations/<id>/manifest. Niezmienione pliki nie są ponownie kopiowane ani czytane,
+// a kolejne generacje współdzielą obiekty.
+class BackupStore {
+private:
+    std::string directory;
+    size_t maxGenerations;
+
+public:
+    explicit BackupStore(std::string directory, size_t maxGenerations = 10);
+    
+    // Migawka plików i katalogów (rekurencyjnie) oraz dodatkowych treści (np. @modules)
+    SnapshotResult snapshot(const std::vector<std::string>& roots,
+                            const std::map<std::string, std::string>& extraContents = {});
+    
+    // Generacje od najstarszej do najnowszej
+    std::vector<std::string> generations() const;
+    std::string latestGeneration() const;
+    bool loadGeneration(const std::string& id, BackupGeneration& generation) const;
+    
+    // Przywrócenie plików generacji (plik tymczasowy + rename); pliki dodane później są usuwane
+    bool restore(const std::string& id, std::vector<std::string>* restoredPaths = nullptr);
+    
+    // Odczyt treści obiektu (np. migawki @modules)
+    bool readObject(const std::string& hash, std::string& contents) const;
+    
+    std::string objectPath(const std::string& hash) const;
+    
+    // Zapis pojedynczego pliku jako obiektu poza generacjami (np. dla dziennika zmian)
+    bool storeFile(const std::string& path, std::string& hash);
+    
+    // Odtworzenie pliku z obiektu (plik tymczasowy + rename)
+    bool restoreObject(const std::string& hash, const std::string& target, unsigned mode);
+
+private:
+    bool storeObject(const std::string& sourcePath, std::string& hash, size_t& stored);
+    bool storeContents(const std::string& contents, std::string& hash, size_t& stored);
+    bool copyObjectTo(const std::string& hash, const std::string& target, unsigned mode);
+    std::string formatManifest(const BackupGeneration& generation) const;
+    bool parseManifest(const std::string& text, BackupGeneration& generation) const;
+    void prune();
+};
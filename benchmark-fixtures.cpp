@@ -0,0 +1,131 @@
+#include "benchmark-fixtures.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+bool writeText(const fs::path& path, const std::string& text) {
+    std::ofstream file(path);
+    file << text;
+    return static_cast<bool>(file);
+}
+
+std::string hex(unsigned value, int width) {
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "0x%0*x", width, value);
+    return buffer;
+}
+
+}
+
+std::vector<HardwareFixture> standardHardwareFixtures() {
+    const FixtureGpu intelIgpu = {"0000:00:02.0", 0x030000, 0x8086, 0x9a49, true, "i915"};
+    const FixtureGpu nvidiaDgpu = {"0000:01:00.0", 0x030200, 0x10de, 0x1f95, false, "nouveau"};
+    const FixtureGpu amdDesktop = {"0000:03:00.0", 0x030000, 0x1002, 0x73bf, true, "amdgpu"};
+    const FixtureGpu nvidiaDesktop = {"0000:01:00.0", 0x030000, 0x10de, 0x2684, true, "nouveau", 0};
+    const FixtureGpu nvidiaSecond = {"0000:81:00.0", 0x030000, 0x10de, 0x2684, false, "nouveau", 1};
+    const FixtureGpu nvidiaKepler = {"0000:01:00.0", 0x030000, 0x10de, 0x0fc6, true, "nouveau"};
+    
+    HardwareFixture failing = {"hybrid-nvidia-failure", {intelIgpu, nvidiaDgpu}, true};
+    
+    return {
+        {"intel-laptop", {intelIgpu}, false},
+        {"amd-desktop", {amdDesktop}, false},
+        {"hybrid-intel-nvidia", {intelIgpu, nvidiaDgpu}, false},
+        {"dual-nvidia-workstation", {nvidiaDesktop, nvidiaSecond}, false},
+        {"intel-amd-nvidia", {intelIgpu, amdDesktop, nvidiaDgpu}, false},
+        {"kepler-legacy-desktop", {nvidiaKepler}, false},
+        failing
+    };
+}
+
+bool writeHardwareFixture(const std::string& root, const HardwareFixture& fixture, const std::string& kernelRelease) {
+    std::error_code error;
+    fs::path base(root);
+    fs::remove_all(base, error);
+    
+    fs::path devices = base / "sys/bus/pci/devices";
+    fs::path drivers = base / "sys/bus/pci/drivers";
+    fs::create_directories(devices, error);
+    fs::create_directories(base / "proc", error);
+    fs::create_directories(base / "etc/X11/xorg.conf.d", error);
+    fs::create_directories(base / "etc/modprobe.d", error);
+    fs::create_directories(base / "etc/udev/rules.d", error);
+    fs::create_directories(base / "var/lib/driver-installer", error);
+    
+    // Moduł NVIDIA jest już zbudowany, więc oczekiwanie na akmods kończy się od razu
+    fs::path extra = base / "lib/modules" / kernelRelease / "extra/nvidia";
+    fs::create_directories(extra, error);
+    writeText(extra / "nvidia.ko.xz", "");
+    
+    // Nagłówki działającego jądra i dwóch starszych, dla których akmods buduje moduł równolegle
+    for (const std::string& kernel : {kernelRelease, std::string("6.8.11-300.fc40.x86_64"),
+                                      std::string("6.9.4-200.fc40.x86_64")}) {
+        fs::create_directories(base / "lib/modules" / kernel / "build", error);
+    }
+    
+    std::string modules;
+    for (const auto& gpu : fixture.gpus) {
+        fs::path device = devices / gpu.slot;
+        fs::create_directories(device, error);
+        writeText(device / "class", hex(gpu.classCode, 6) + "\n");
+        writeText(device / "vendor", hex(gpu.vendorId, 4) + "\n");
+        writeText(device / "device", hex(gpu.deviceId, 4) + "\n");
+        writeText(device / "subsystem_vendor", "0x17aa\n");
+        writeText(device / "subsystem_device", "0x3a47\n");
+        if ((gpu.classCode >> 8) == 0x0300) {
+            writeText(device / "boot_vga", gpu.bootVga ? "1\n" : "0\n");
+        writeText(device / "numa_node", std::to_string(gpu.numaNode) + "\n");
+        }
+        
+        if (!gpu.driver.empty()) {
+            fs::create_directories(drivers / gpu.driver, error);
+            fs::create_symlink(drivers / gpu.driver, device / "driver", error);
+            if (modules.find(gpu.driver + " ") == std::string::npos) {
+                modules += gpu.driver + " 4096 1 - Live 0x0000000000000000\n";
+            }
+        }
+    }
+    
+    // Urządzenie spoza klasy wyświetlania musi zostać pominięte przy wykrywaniu
+    fs::create_directories(devices / "0000:00:1f.0", error);
+    writeText(devices / "0000:00:1f.0/class", "0x060100\n");
+    writeText(devices / "0000:00:1f.0/vendor", "0x8086\n");
+    writeText(devices / "0000:00:1f.0/device", "0xa082\n");
+    
+    // Karty DRM: główna karta wyświetla obraz na wbudowanym ekranie, pozostałe nie mają wyjść
+    fs::path drm = base / "sys/class/drm";
+    fs::create_directories(drm, error);
+    for (size_t i = 0; i < fixture.gpus.size(); ++i) {
+        const FixtureGpu& gpu = fixture.gpus[i];
+        if (gpu.driver.empty()) {
+            continue;
+        }
+        fs::path card = drm / ("card" + std::to_string(i));
+        fs::create_directories(card, error);
+        fs::create_symlink(devices / gpu.slot, card / "device", error);
+        if (gpu.bootVga) {
+            fs::path connector = drm / ("card" + std::to_string(i) + "-eDP-1");
+            fs::create_directories(connector, error);
+            writeText(connector / "status", "connected\n");
+            writeText(connector / "enabled", "enabled\n");
+        }
+    }
+    
+    // Działająca sesja GNOME na Waylandzie
+    fs::create_directories(base / "proc/1", error);
+    writeText(base / "proc/1/comm", "systemd\n");
+    fs::create_directories(base / "proc/1873", error);
+    writeText(base / "proc/1873/comm", "gnome-shell\n");
+    fs::create_directories(base / "proc/1902", error);
+    writeText(base / "proc/1902/comm", "Xwayland\n");
+    
+    writeText(base / "proc/modules", modules);
+    writeText(base / "etc/X11/xorg.conf", "Section \"ServerFlags\"\nEndSection\n");
+    
+    return fs::is_directory(devices, error) && fs::exists(base / "proc/modules", error);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Karta graficzna w drzewie testowym
+struct FixtureGpu {
+    std::string slot;         // Adres BDF
+    uint32_t classCode;       // Kod klasy PCI
+    uint16_t vendorId;
+    uint16_t deviceId;
+    bool bootVga;
+    std::string driver;       // Związany sterownik (pusty: brak)
+    int numaNode = -1;        // Węzeł NUMA (-1: system jednowęzłowy)
+};
+
+// Opis maszyny, dla której budowane jest drzewo sysfs/procfs/etc
+struct HardwareFixture {
+    std::string name;
+    std::vector<FixtureGpu> gpus;
+    bool failNvidiaInstall = false;  // Wstrzyknięcie błędu instalacji pakietów NVIDIA
+};
+
+// Typowe konfiguracje sprzętowe używane przez benchmark
+std::vector<HardwareFixture> standardHardwareFixtures();
+
+// Utworzenie drzewa <root>/{sys,proc,lib/modules,etc/{X11,modprobe.d,udev},var/lib/driver-installer}
+bool writeHardwareFixture(const std::string& root, const HardwareFixture& fixture, const std::string& kernelRelease);
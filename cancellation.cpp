@@ -0,0 +1,62 @@
+#include "cancellation.h"
+
+#include <cstdint>
+
+// Dla eventfd
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+Cancellation::Cancellation() {
+    eventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+}
+
+Cancellation::~Cancellation() {
+    if (eventFd >= 0) {
+        close(eventFd);
+    }
+}
+
+bool Cancellation::cancel() {
+    if (!allowed) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    requested = true;
+    if (!deferred) {
+        signal();
+    }
+    return true;
+}
+
+void Cancellation::setAllowed(bool value) {
+    allowed = value;
+}
+
+void Cancellation::setDeferred(bool value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    deferred = value;
+    if (!deferred && requested) {
+        signal();
+    }
+}
+
+void Cancellation::signal() {
+    if (signalled || eventFd < 0) {
+        return;
+    }
+    signalled = true;
+    uint64_t value = 1;
+    ssize_t written = write(eventFd, &value, sizeof(value));
+    (void)written;
+}
+
+void Cancellation::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    requested = false;
+    signalled = false;
+    if (eventFd >= 0) {
+        uint64_t value;
+        ssize_t size = read(eventFd, &value, sizeof(value));
+        (void)size;
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+// Żądanie przerwania instalacji zgłaszane z innego wątku (np. polecenie cancel z gniazda postępu).
+// Deskryptor eventfd staje się czytelny po cancel(), więc oczekiwania oparte na poll
+// (procesy potomne, budowanie modułu jądra) kończą się od razu, bez odpytywania flagi.
+class Cancellation {
+private:
+    int eventFd = -1;
+    std::atomic<bool> requested{false};
+    std::atomic<bool> allowed{true};
+    std::mutex mutex;
+    bool deferred = false;     // Żądanie czeka na koniec operacji, zamiast ją zatrzymać
+    bool signalled = false;    // eventfd już ustawiony
+    
+    void signal();
+
+public:
+    Cancellation();
+    ~Cancellation();
+    
+    Cancellation(const Cancellation&) = delete;
+    Cancellation& operator=(const Cancellation&) = delete;
+    
+    // Zgłoszenie przerwania; false, gdy przerwanie jest zablokowane (wycofywanie zmian)
+    bool cancel();
+    
+    // Blokada przerwania na czas operacji, których nie wolno zatrzymać w połowie
+    void setAllowed(bool value);
+    
+    // Odroczenie przerwania (transakcja rpm): żądanie jest przyjmowane, ale deskryptor
+    // staje się czytelny dopiero po setDeferred(false), więc działające polecenie nie jest zabijane
+    void setDeferred(bool value);
+    
+    // Wyczyszczenie żądania, np. przed wycofaniem zmian przerwanej instalacji
+    void reset();
+    
+    bool isRequested() const { return requested; }
+    
+    // Deskryptor do poll: POLLIN po cancel() (-1, jeśli eventfd jest niedostępny)
+    int fd() const { return eventFd; }
+};
@@ -0,0 +1,144 @@
+#include "change-journal.h"
+#include "file-utils.h"
+
+#include <cerrno>
+#include <filesystem>
+#include <sstream>
+#include <utility>
+
+// Dla zapisu wpisów z O_APPEND i fdatasync
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+ChangeJournal::ChangeJournal(std::string directory)
+    : directory(directory), objects(std::move(directory)) {
+}
+
+bool ChangeJournal::begin() {
+    std::lock_guard<std::mutex> lock(mutex);
+    recordedFiles.clear();
+    
+    std::error_code error;
+    fs::remove_all(directory + "/objects", error);
+    fs::create_directories(directory, error);
+    return writeFileAtomically(journalPath(), "");
+}
+
+bool ChangeJournal::recordTransaction(const std::string& id, const std::string& scope) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return append("transaction\t" + id + "\t" + scope);
+}
+
+bool ChangeJournal::recordFileChange(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (recordedFiles.count(path)) {
+        return true;
+    }
+    
+    std::string hash = "-";
+    unsigned mode = 0644;
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0) {
+        if (!S_ISREG(info.st_mode) || !objects.storeFile(path, hash)) {
+            return false;
+        }
+        mode = info.st_mode & 07777;
+    } else if (errno != ENOENT) {
+        return false;
+    }
+    
+    std::ostringstream modeText;
+    modeText << std::oct << mode;
+    if (!append("file\t" + hash + "\t" + modeText.str() + "\t" + path)) {
+        return false;
+    }
+    recordedFiles.insert(path);
+    return true;
+}
+
+bool ChangeJournal::recordModuleChange(const std::string& name, const std::string& action) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return append("module\t" + name + "\t" + action);
+}
+
+std::vector<ChangeRecord> ChangeJournal::records() const {
+    std::vector<ChangeRecord> result;
+    std::istringstream stream(readFileContents(journalPath()));
+    std::string line;
+    while (std::getline(stream, line)) {
+        std::vector<std::string> fields;
+        std::istringstream lineStream(line);
+        std::string field;
+        while (std::getline(lineStream, field, '\t')) {
+            fields.push_back(field);
+        }
+        
+        ChangeRecord record;
+        if (fields.size() == 3 && fields[0] == "transaction") {
+            record.kind = ChangeKind::TRANSACTION;
+            record.subject = fields[1];
+            record.detail = fields[2];
+        } else if (fields.size() == 4 && fields[0] == "file") {
+            record.kind = ChangeKind::FILE;
+            record.hash = fields[1];
+            record.mode = static_cast<unsigned>(std::stoul(fields[2], nullptr, 8));
+            record.subject = fields[3];
+        } else if (fields.size() == 3 && fields[0] == "module") {
+            record.kind = ChangeKind::MODULE;
+            record.subject = fields[1];
+            record.detail = fields[2];
+        } else {
+            // Niepełny ostatni wpis (przerwany zapis) jest pomijany
+            continue;
+        }
+        result.push_back(record);
+    }
+    return result;
+}
+
+bool ChangeJournal::finish() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return append("end");
+}
+
+bool ChangeJournal::interrupted() const {
+    std::string contents = readFileContents(journalPath());
+    size_t end = contents.find_last_not_of('\n');
+    if (end == std::string::npos || records().empty()) {
+        return false;
+    }
+    size_t start = contents.rfind('\n', end);
+    start = start == std::string::npos ? 0 : start + 1;
+    return contents.compare(start, end - start + 1, "end") != 0;
+}
+
+bool ChangeJournal::restoreFile(const ChangeRecord& record) {
+    if (record.kind != ChangeKind::FILE) {
+        return false;
+    }
+    if (record.hash == "-") {
+        return unlink(record.subject.c_str()) == 0 || errno == ENOENT;
+    }
+    return objects.restoreObject(record.hash, record.subject, record.mode);
+}
+
+std::string ChangeJournal::journalPath() const {
+    return directory + "/changes";
+}
+
+bool ChangeJournal::append(const std::string& line) {
+    int fd = open(journalPath().c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    
+    // Jeden write na wpis: przerwany zapis zostawia co najwyżej niepełną ostatnią linię
+    std::string entry = line + "\n";
+    bool written = write(fd, entry.data(), entry.size()) == static_cast<ssize_t>(entry.size());
+    written = written && fdatasync(fd) == 0;
+    close(fd);
+    return written;
+}
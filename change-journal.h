@@ -0,0 +1,67 @@
+#pragma once
+
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "backup-store.h"
+
+// Rodzaj zmiany wprowadzonej w systemie przez instalator
+enum class ChangeKind {
+    TRANSACTION,  // Transakcja dnf (subject: identyfikator, detail: zakres, np. drivers)
+    FILE,         // Plik zapisany przez instalator (subject: ścieżka)
+    MODULE        // Moduł jądra zbudowany lub załadowany (subject: nazwa, detail: czynność)
+};
+
+// Pojedynczy wpis dziennika zmian
+struct ChangeRecord {
+    ChangeKind kind = ChangeKind::FILE;
+    std::string subject;
+    std::string detail;
+    std::string hash;         // FILE: obiekt z poprzednią zawartością, "-" gdy pliku nie było
+    unsigned mode = 0644;     // FILE: poprzednie uprawnienia
+};
+
+// Dziennik zmian jednego przebiegu instalatora (<katalog>/changes) z poprzednimi
+// zawartościami plików w <katalog>/objects. Każdy wpis jest zapisywany na dysk od razu,
+// więc po awarii lub restarcie zmiany nadal da się wycofać w odwrotnej kolejności.
+class ChangeJournal {
+private:
+    std::string directory;
+    BackupStore objects;
+    mutable std::mutex mutex;
+    std::set<std::string> recordedFiles;
+
+public:
+    explicit ChangeJournal(std::string directory);
+    
+    // Rozpoczęcie nowego przebiegu: usunięcie wpisów i obiektów poprzedniego
+    bool begin();
+    
+    bool recordTransaction(const std::string& id, const std::string& scope);
+    
+    // Zapamiętanie stanu pliku przed jego zmianą (wywoływane przed zapisem);
+    // liczy się tylko pierwszy zapis danej ścieżki w przebiegu
+    bool recordFileChange(const std::string& path);
+    
+    bool recordModuleChange(const std::string& name, const std::string& action);
+    
+    // Wpisy w kolejności wprowadzania zmian
+    std::vector<ChangeRecord> records() const;
+    
+    // Znacznik normalnego zakończenia przebiegu. Wpisy zostają (do --rollback), ale dziennik
+    // bez znacznika oznacza przebieg przerwany awarią, restartem lub sygnałem.
+    bool finish();
+    
+    // Czy dziennik zawiera zmiany przebiegu, który nie dobiegł końca
+    bool interrupted() const;
+    
+    // Przywrócenie poprzedniej zawartości pliku albo usunięcie pliku utworzonego przez instalator
+    bool restoreFile(const ChangeRecord& record);
+    
+    std::string journalPath() const;
+
+private:
+    bool append(const std::string& line);
+};
@@ -0,0 +1,55 @@
+#include "command-runner.h"
+#include "process-runner.h"
+
+SystemCommandRunner::SystemCommandRunner(std::chrono::milliseconds defaultTimeout) : defaultTimeout(defaultTimeout) {
+}
+
+CommandResult SystemCommandRunner::run(const std::vector<std::string>& argv, const OutputCallback& onOutput) {
+    CommandResult result;
+    if (argv.empty()) {
+        return result;
+    }
+    
+    ProcessOptions options;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = timeouts.find(argv[0]);
+        options.timeout = it == timeouts.end() ? defaultTimeout : it->second;
+        auto environment = environments.find(argv[0]);
+        if (environment != environments.end()) {
+            options.environment = environment->second;
+        }
+        options.cancelFd = cancelFd;
+    }
+    if (onOutput) {
+        options.captureOutput = false;
+        options.onLine = [&onOutput](ProcessStream, const std::string& line) {
+            onOutput(line);
+        };
+    }
+    
+    ProcessResult process = ProcessRunner::run(argv, options);
+    result.exitCode = process.exitCode;
+    result.output = std::move(process.standardOutput);
+    result.errorOutput = std::move(process.standardError);
+    result.signal = process.signal;
+    result.timedOut = process.timedOut;
+    result.cancelled = process.cancelled;
+    result.duration = process.duration;
+    return result;
+}
+
+void SystemCommandRunner::setTimeout(const std::string& program, std::chrono::milliseconds timeout) {
+    std::lock_guard<std::mutex> lock(mutex);
+    timeouts[program] = timeout;
+}
+
+void SystemCommandRunner::setEnvironment(const std::string& program, std::vector<std::string> environment) {
+    std::lock_guard<std::mutex> lock(mutex);
+    environments[program] = std::move(environment);
+}
+
+void SystemCommandRunner::setCancelFd(int fd) {
+    std::lock_guard<std::mutex> lock(mutex);
+    cancelFd = fd;
+}
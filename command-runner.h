@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Wynik wykonania polecenia zewnętrznego
+struct CommandResult {
+    int exitCode = -1;                      // Kod wyjścia (-1, jeśli proces nie wystartował lub zabił go sygnał)
+    std::string output;                     // Przechwycone standardowe wyjście
+    std::string errorOutput;                // Przechwycone wyjście błędów
+    int signal = 0;                         // Sygnał, który zakończył proces
+    bool timedOut = false;                  // Czy przekroczono limit czasu
+    bool cancelled = false;                 // Czy polecenie przerwano (lub nie uruchomiono) na żądanie
+    std::chrono::milliseconds duration{0};  // Czas działania
+    
+    bool success() const {
+        return exitCode == 0;
+    }
+};
+
+// Uruchamianie poleceń zewnętrznych; implementacja systemowa lub symulowana
+class CommandRunner {
+public:
+    // Wywoływane z kolejnymi liniami wyjścia (stdout i stderr) w trakcie działania polecenia;
+    // wyjście przekazane w ten sposób nie jest zbierane w wyniku (długie transakcje dnf)
+    using OutputCallback = std::function<void(const std::string& line)>;
+    
+    virtual ~CommandRunner() = default;
+    
+    // Uruchomienie programu z listą argumentów (argv[0] to nazwa programu)
+    virtual CommandResult run(const std::vector<std::string>& argv, const OutputCallback& onOutput = nullptr) = 0;
+};
+
+// Uruchamianie poleceń w systemie przez posix_spawn, bez powłoki, z limitem czasu
+class SystemCommandRunner : public CommandRunner {
+private:
+    std::mutex mutex;
+    std::chrono::milliseconds defaultTimeout;
+    std::map<std::string, std::chrono::milliseconds> timeouts;
+    std::map<std::string, std::vector<std::string>> environments;
+    int cancelFd = -1;
+
+public:
+    // Limit czasu 0 oznacza brak limitu
+    explicit SystemCommandRunner(std::chrono::milliseconds defaultTimeout = std::chrono::milliseconds(0));
+    
+    CommandResult run(const std::vector<std::string>& argv, const OutputCallback& onOutput = nullptr) override;
+    
+    // Osobny limit czasu dla programu (np. krótszy dla pgrep niż dla dnf)
+    void setTimeout(const std::string& program, std::chrono::milliseconds timeout);
+    
+    // Dodatkowe zmienne środowiska (KLUCZ=wartość) dla każdego uruchomienia programu
+    void setEnvironment(const std::string& program, std::vector<std::string> environment);
+    
+    // Deskryptor, którego gotowość do odczytu zabija działające polecenia i blokuje kolejne
+    void setCancelFd(int fd);
+};
@@ -0,0 +1,167 @@
+#include "display-config.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+
+namespace {
+
+// Pliki zarządzane przez generator (względem katalogów z DisplayConfigPaths)
+const char* const xorgFile = "/xorg.conf.d/10-auto-driver-installer.conf";
+const char* const modprobeFile = "/nvidia-runtime-pm.conf";
+const char* const udevRulesFile = "/80-nvidia-runtime-pm.rules";
+
+std::string deviceIdentifier(const GraphicsDevice& device, size_t index) {
+    return device.vendor + std::to_string(index);
+}
+
+}
+
+DisplayConfigGenerator::DisplayConfigGenerator(DisplayConfigPaths paths) : paths(std::move(paths)) {
+}
+
+std::string DisplayConfigGenerator::xorgBusId(const std::string& slot) {
+    unsigned domain = 0, bus = 0, device = 0, function = 0;
+    if (std::sscanf(slot.c_str(), "%x:%x:%x.%x", &domain, &bus, &device, &function) != 4) {
+        return "";
+    }
+    
+    // Domena inna niż 0 (np. Thunderbolt, serwery wieloprocesorowe) w formacie PCI:bus@domena:urz:fun
+    std::string busPart = std::to_string(bus) + (domain != 0 ? "@" + std::to_string(domain) : "");
+    return "PCI:" + busPart + ":" + std::to_string(device) + ":" + std::to_string(function);
+}
+
+std::string DisplayConfigGenerator::xorgDriver(DriverType type) {
+    switch (type) {
+        case DriverType::NVIDIA_PROPRIETARY:
+        case DriverType::NVIDIA_LEGACY_470:
+        case DriverType::NVIDIA_LEGACY_390:
+        case DriverType::NVIDIA_OPEN:
+            return "nvidia";
+        case DriverType::NVIDIA_NOUVEAU: return "nouveau";
+        case DriverType::AMD_PROPRIETARY:
+        case DriverType::AMD_OPEN:
+            return "amdgpu";
+        case DriverType::INTEL_OPEN: return "intel";
+        default: return "";
+    }
+}
+
+bool DisplayConfigGenerator::supportsRuntimeD3(DriverType type) {
+    // Gałęzie legacy obsługują tylko Keplera i starsze karty, bez runtime D3
+    return type == DriverType::NVIDIA_PROPRIETARY || type == DriverType::NVIDIA_OPEN;
+}
+
+std::vector<DisplayConfigFile> DisplayConfigGenerator::generate(const std::vector<GraphicsDevice>& devices) const {
+    std::vector<DisplayConfigFile> files;
+    
+    std::vector<size_t> usable;
+    for (size_t i = 0; i < devices.size(); ++i) {
+        if (!xorgDriver(devices[i].driverType).empty() && !xorgBusId(devices[i].busId).empty()) {
+            usable.push_back(i);
+        }
+    }
+    if (usable.empty()) {
+        return files;
+    }
+    
+    // Karta główna wyświetla obraz; bez boot_vga wśród kart do konfiguracji pierwsza z nich
+    auto primaryIt = std::find_if(usable.begin(), usable.end(), [&devices](size_t index) {
+        return devices[index].isPrimary;
+    });
+    size_t primary = primaryIt == usable.end() ? usable.front() : *primaryIt;
+    
+    // Pozostałe karty: najpierw z tego samego węzła NUMA co główna (krótsza droga kopii bufora
+    // ramki między kartami), potem według węzła i adresu
+    std::vector<size_t> secondary;
+    for (size_t index : usable) {
+        if (index != primary) {
+            secondary.push_back(index);
+        }
+    }
+    int primaryNode = devices[primary].numaNode;
+    std::stable_sort(secondary.begin(), secondary.end(), [&devices, primaryNode](size_t a, size_t b) {
+        bool aLocal = devices[a].numaNode == primaryNode;
+        bool bLocal = devices[b].numaNode == primaryNode;
+        if (aLocal != bLocal) {
+            return aLocal;
+        }
+        return devices[a].numaNode < devices[b].numaNode;
+    });
+    
+    // Render offload NVIDIA: obraz na karcie głównej innej niż nvidia, renderowanie na karcie NVIDIA
+    bool primaryNvidia = xorgDriver(devices[primary].driverType) == "nvidia";
+    bool nvidiaOffload = false;
+    bool runtimePm = false;
+    for (size_t index : secondary) {
+        if (xorgDriver(devices[index].driverType) == "nvidia") {
+            nvidiaOffload = nvidiaOffload || !primaryNvidia;
+            runtimePm = runtimePm || (!primaryNvidia && supportsRuntimeD3(devices[index].driverType));
+        }
+    }
+    
+    std::string xorg = "# Wygenerowane przez auto-driver-installer; zmiany zostaną nadpisane\n\n";
+    std::string primaryId = deviceIdentifier(devices[primary], 0);
+    xorg += "Section \"ServerLayout\"\n";
+    xorg += "    Identifier \"Layout\"\n";
+    xorg += "    Screen 0 \"" + primaryId + "\"\n";
+    if (nvidiaOffload) {
+        xorg += "    Option \"AllowNVIDIAGPUScreens\"\n";
+    }
+    xorg += "EndSection\n";
+    
+    std::vector<size_t> ordered = {primary};
+    ordered.insert(ordered.end(), secondary.begin(), secondary.end());
+    for (size_t position = 0; position < ordered.size(); ++position) {
+        const GraphicsDevice& device = devices[ordered[position]];
+        std::string driver = xorgDriver(device.driverType);
+        std::string identifier = deviceIdentifier(device, position);
+        
+        xorg += "\n# " + device.vendor + " " + device.model + " [" + device.pciId + "] " + device.busId;
+        xorg += device.numaNode >= 0 ? ", węzeł NUMA " + std::to_string(device.numaNode) + "\n" : "\n";
+        xorg += "Section \"Device\"\n";
+        xorg += "    Identifier \"" + identifier + "\"\n";
+        xorg += "    Driver \"" + driver + "\"\n";
+        xorg += "    BusID \"" + xorgBusId(device.busId) + "\"\n";
+        if (driver == "amdgpu" || driver == "intel") {
+            xorg += "    Option \"TearFree\" \"true\"\n";
+        }
+        xorg += "EndSection\n";
+        
+        if (position == 0) {
+            xorg += "\nSection \"Screen\"\n";
+            xorg += "    Identifier \"" + identifier + "\"\n";
+            xorg += "    Device \"" + identifier + "\"\n";
+            xorg += "EndSection\n";
+        }
+    }
+    files.push_back({paths.x11Dir + xorgFile, xorg});
+    
+    // Karta NVIDIA w trybie offload wyłączana, gdy nic na niej nie renderuje
+    if (runtimePm) {
+        files.push_back({paths.modprobeDir + modprobeFile,
+                         "# Dynamiczne zarządzanie energią karty NVIDIA (runtime D3)\n"
+                         "options nvidia NVreg_DynamicPowerManagement=0x02\n"});
+        files.push_back({paths.udevRulesDir + udevRulesFile,
+                         "# Automatyczne usypianie kart NVIDIA (VGA i 3D) po związaniu sterownika\n"
+                         "ACTION==\"bind\", SUBSYSTEM==\"pci\", ATTR{vendor}==\"0x10de\", ATTR{class}==\"0x03[0-9]*\", "
+                         "TEST==\"power/control\", ATTR{power/control}=\"auto\"\n"
+                         "ACTION==\"unbind\", SUBSYSTEM==\"pci\", ATTR{vendor}==\"0x10de\", ATTR{class}==\"0x03[0-9]*\", "
+                         "TEST==\"power/control\", ATTR{power/control}=\"on\"\n"});
+    }
+    return files;
+}
+
+std::vector<std::string> DisplayConfigGenerator::obsoleteFiles(const std::vector<DisplayConfigFile>& generated) const {
+    std::vector<std::string> obsolete;
+    for (const std::string& path : {paths.x11Dir + xorgFile, paths.modprobeDir + modprobeFile,
+                                    paths.udevRulesDir + udevRulesFile}) {
+        bool kept = std::any_of(generated.begin(), generated.end(), [&path](const DisplayConfigFile& file) {
+            return file.path == path;
+        });
+        if (!kept) {
+            obsolete.push_back(path);
+        }
+    }
+    return obsolete;
+}
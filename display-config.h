@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "graphics-device.h"
+
+// Katalogi, w których zapisywana jest konfiguracja wyświetlania
+struct DisplayConfigPaths {
+    std::string x11Dir = "/etc/X11";
+    std::string modprobeDir = "/etc/modprobe.d";
+    std::string udevRulesDir = "/etc/udev/rules.d";
+};
+
+// Plik konfiguracji do zapisania
+struct DisplayConfigFile {
+    std::string path;
+    std::string contents;
+};
+
+// Generator konfiguracji dla wszystkich kart jednocześnie: sekcje Device z BusID każdej karty,
+// ServerLayout z ekranem na karcie głównej (boot_vga), render offload NVIDIA PRIME, gdy
+// obraz wyświetla inna karta, i zarządzanie energią (runtime D3) dla karty NVIDIA w trybie offload
+class DisplayConfigGenerator {
+private:
+    DisplayConfigPaths paths;
+
+public:
+    explicit DisplayConfigGenerator(DisplayConfigPaths paths = DisplayConfigPaths());
+    
+    // Karty bez znanego sterownika X (GENERIC, UNKNOWN) są pomijane
+    std::vector<DisplayConfigFile> generate(const std::vector<GraphicsDevice>& devices) const;
+    
+    // Pliki generatora, których nie ma w wyniku generate() i które należy usunąć (np. runtime D3
+    // po odłączeniu eGPU albo xorg.conf.d ze starymi BusID, gdy żadna karta nie ma sterownika X)
+    std::vector<std::string> obsoleteFiles(const std::vector<DisplayConfigFile>& generated) const;
+    
+    // Adres BDF w formacie BusID serwera X (dziesiętnie, np. 0000:01:00.0 -> PCI:1:0:0)
+    static std::string xorgBusId(const std::string& slot);
+    
+    // Nazwa sterownika X dla gałęzi (pusta: brak)
+    static std::string xorgDriver(DriverType type);
+    
+    // Gałęzie z obsługą dynamicznego zarządzania energią (Turing i nowsze)
+    static bool supportsRuntimeD3(DriverType type);
+    
+    const DisplayConfigPaths& configPaths() const { return paths; }
+};
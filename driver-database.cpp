@@ -0,0 +1,368 @@
+#include "driver-database.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <utility>
+
+// Dla mapowania pliku bazy do pamięci
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char databaseMagic[8] = {'P', 'C', 'I', 'D', 'R', 'V', 'D', 'B'};
+
+const std::pair<DriverType, const char*> driverTypeNames[] = {
+    {DriverType::NVIDIA_PROPRIETARY, "NVIDIA_PROPRIETARY"},
+    {DriverType::NVIDIA_LEGACY_470, "NVIDIA_LEGACY_470"},
+    {DriverType::NVIDIA_LEGACY_390, "NVIDIA_LEGACY_390"},
+    {DriverType::NVIDIA_OPEN, "NVIDIA_OPEN"},
+    {DriverType::NVIDIA_NOUVEAU, "NVIDIA_NOUVEAU"},
+    {DriverType::AMD_PROPRIETARY, "AMD_PROPRIETARY"},
+    {DriverType::AMD_OPEN, "AMD_OPEN"},
+    {DriverType::INTEL_OPEN, "INTEL_OPEN"},
+    {DriverType::GENERIC, "GENERIC"},
+    {DriverType::UNKNOWN, "UNKNOWN"}
+};
+
+uint32_t makeKey(uint16_t vendorId, uint16_t deviceId) {
+    return (static_cast<uint32_t>(vendorId) << 16) | deviceId;
+}
+
+bool parseHex16(const std::string& text, uint16_t& value) {
+    if (text.empty() || text.size() > 4 || text.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) {
+        return false;
+    }
+    value = static_cast<uint16_t>(std::stoul(text, nullptr, 16));
+    return true;
+}
+
+template <typename T>
+void appendRaw(std::string& output, const T& value) {
+    output.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+}
+
+std::string driverTypeName(DriverType type) {
+    for (const auto& entry : driverTypeNames) {
+        if (entry.first == type) {
+            return entry.second;
+        }
+    }
+    return "UNKNOWN";
+}
+
+bool parseDriverType(const std::string& name, DriverType& type) {
+    for (const auto& entry : driverTypeNames) {
+        if (name == entry.second) {
+            type = entry.first;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t pciDatabaseHash(uint32_t key, uint32_t seed) {
+    // Końcowe mieszanie MurmurHash3 (fmix32)
+    uint32_t h = key ^ seed;
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+    return h;
+}
+
+PciDriverDatabase::~PciDriverDatabase() {
+    close();
+}
+
+bool PciDriverDatabase::open(const std::string& path) {
+    close();
+    
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return false;
+    }
+    
+    size_t size = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    mapping = data;
+    mappingSize = size;
+    
+    const auto* candidate = static_cast<const Header*>(data);
+    if (std::memcmp(candidate->magic, databaseMagic, sizeof(databaseMagic)) != 0 ||
+        candidate->version != formatVersion || candidate->bucketCount == 0 || candidate->slotCount == 0) {
+        close();
+        return false;
+    }
+    
+    // Rozmiary tablic z nagłówka muszą zgadzać się z rozmiarem pliku
+    uint64_t expected = sizeof(Header) + uint64_t(candidate->bucketCount) * sizeof(uint32_t) +
+                        uint64_t(candidate->slotCount) * sizeof(Slot) +
+                        uint64_t(candidate->branchCount) * sizeof(Branch) + candidate->stringsSize;
+    if (expected != size) {
+        close();
+        return false;
+    }
+    
+    const char* base = static_cast<const char*>(data) + sizeof(Header);
+    displacements = reinterpret_cast<const uint32_t*>(base);
+    base += candidate->bucketCount * sizeof(uint32_t);
+    slots = reinterpret_cast<const Slot*>(base);
+    base += candidate->slotCount * sizeof(Slot);
+    branches = reinterpret_cast<const Branch*>(base);
+    base += candidate->branchCount * sizeof(Branch);
+    strings = base;
+    
+    for (uint32_t i = 0; i < candidate->branchCount; ++i) {
+        if (uint64_t(branches[i].offset) + branches[i].length > candidate->stringsSize) {
+            close();
+            return false;
+        }
+    }
+    
+    header = candidate;
+    return true;
+}
+
+bool PciDriverDatabase::lookupDevice(uint16_t vendorId, uint16_t deviceId, DriverType& type) const {
+    return deviceId != vendorDefaultDevice && lookupKey(makeKey(vendorId, deviceId), type);
+}
+
+bool PciDriverDatabase::lookupVendor(uint16_t vendorId, DriverType& type) const {
+    return lookupKey(makeKey(vendorId, vendorDefaultDevice), type);
+}
+
+bool PciDriverDatabase::packages(DriverType type, std::vector<std::string>& result) const {
+    if (!header) {
+        return false;
+    }
+    
+    for (uint32_t i = 0; i < header->branchCount; ++i) {
+        if (branches[i].type != static_cast<uint32_t>(type)) {
+            continue;
+        }
+        result.clear();
+        std::istringstream stream(std::string(strings + branches[i].offset, branches[i].length));
+        std::string package;
+        while (stream >> package) {
+            result.push_back(package);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool PciDriverDatabase::lookupKey(uint32_t key, DriverType& type) const {
+    if (!header) {
+        return false;
+    }
+    
+    uint32_t bucket = pciDatabaseHash(key, header->seed) % header->bucketCount;
+    const Slot& slot = slots[pciDatabaseHash(key, displacements[bucket]) % header->slotCount];
+    if (slot.key != key || slot.type > static_cast<uint32_t>(DriverType::UNKNOWN)) {
+        return false;
+    }
+    type = static_cast<DriverType>(slot.type);
+    return true;
+}
+
+void PciDriverDatabase::close() {
+    if (mapping) {
+        munmap(mapping, mappingSize);
+    }
+    mapping = nullptr;
+    mappingSize = 0;
+    header = nullptr;
+    displacements = nullptr;
+    slots = nullptr;
+    branches = nullptr;
+    strings = nullptr;
+}
+
+void PciDriverDatabaseBuilder::addDevice(uint16_t vendorId, uint16_t deviceId, DriverType type) {
+    entries[makeKey(vendorId, deviceId)] = type;
+}
+
+void PciDriverDatabaseBuilder::addVendorDefault(uint16_t vendorId, DriverType type) {
+    entries[makeKey(vendorId, PciDriverDatabase::vendorDefaultDevice)] = type;
+}
+
+void PciDriverDatabaseBuilder::setPackages(DriverType type, std::vector<std::string> packages) {
+    branchPackages[type] = std::move(packages);
+}
+
+bool PciDriverDatabaseBuilder::parseSource(const std::string& text, std::string& error) {
+    std::istringstream stream(text);
+    std::string line;
+    int lineNumber = 0;
+    
+    while (std::getline(stream, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+        
+        std::istringstream fields(line);
+        std::vector<std::string> words;
+        std::string word;
+        while (fields >> word) {
+            words.push_back(word);
+        }
+        if (words.empty()) {
+            continue;
+        }
+        
+        std::string where = "linia " + std::to_string(lineNumber) + ": ";
+        DriverType type;
+        if (words[0] == "branch" && words.size() >= 2) {
+            if (!parseDriverType(words[1], type)) {
+                error = where + "nieznany typ sterownika " + words[1];
+                return false;
+            }
+            setPackages(type, std::vector<std::string>(words.begin() + 2, words.end()));
+        } else if (words[0] == "vendor" && words.size() == 3) {
+            uint16_t vendorId;
+            if (!parseHex16(words[1], vendorId) || !parseDriverType(words[2], type)) {
+                error = where + "niepoprawny wpis vendor";
+                return false;
+            }
+            addVendorDefault(vendorId, type);
+        } else if (words[0] == "device" && words.size() == 4) {
+            uint16_t vendorId, first, last;
+            std::string range = words[2];
+            size_t dash = range.find('-');
+            bool valid = parseHex16(words[1], vendorId) && parseDriverType(words[3], type) &&
+                         parseHex16(range.substr(0, dash), first) &&
+                         parseHex16(dash == std::string::npos ? range : range.substr(dash + 1), last);
+            if (!valid || last < first || last == PciDriverDatabase::vendorDefaultDevice) {
+                error = where + "niepoprawny wpis device";
+                return false;
+            }
+            for (uint32_t device = first; device <= last; ++device) {
+                addDevice(vendorId, static_cast<uint16_t>(device), type);
+            }
+        } else {
+            error = where + "nieznany wpis " + words[0];
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string PciDriverDatabaseBuilder::build() const {
+    uint32_t keyCount = static_cast<uint32_t>(entries.size());
+    uint32_t bucketCount = std::max<uint32_t>(1, (keyCount + 3) / 4);
+    uint32_t slotCount = std::max<uint32_t>(1, keyCount + keyCount / 16 + 1);
+    
+    std::vector<uint32_t> displacements;
+    std::vector<PciDriverDatabase::Slot> slots;
+    uint32_t seed = 0x9e3779b9;
+    bool found = false;
+    
+    // Hash and displace: kubełki od największego; dla każdego szukane przesunięcie,
+    // przy którym wszystkie jego klucze trafiają w wolne, różne pozycje
+    for (uint32_t attempt = 0; attempt < 16 && !found; ++attempt) {
+        if (attempt > 0) {
+            seed = pciDatabaseHash(seed, attempt);
+        }
+        std::vector<std::vector<uint32_t>> buckets(bucketCount);
+        for (const auto& entry : entries) {
+            buckets[pciDatabaseHash(entry.first, seed) % bucketCount].push_back(entry.first);
+        }
+        std::vector<uint32_t> order(bucketCount);
+        for (uint32_t i = 0; i < bucketCount; ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return buckets[a].size() > buckets[b].size();
+        });
+        
+        displacements.assign(bucketCount, 0);
+        slots.assign(slotCount, {PciDriverDatabase::emptyKey, static_cast<uint32_t>(DriverType::UNKNOWN)});
+        found = true;
+        
+        std::vector<uint32_t> positions;
+        for (uint32_t bucket : order) {
+            if (buckets[bucket].empty()) {
+                break;
+            }
+            
+            bool placed = false;
+            for (uint32_t displacement = 1; displacement < (1u << 20) && !placed; ++displacement) {
+                positions.clear();
+                placed = true;
+                for (uint32_t key : buckets[bucket]) {
+                    uint32_t position = pciDatabaseHash(key, displacement) % slotCount;
+                    if (slots[position].key != PciDriverDatabase::emptyKey ||
+                        std::find(positions.begin(), positions.end(), position) != positions.end()) {
+                        placed = false;
+                        break;
+                    }
+                    positions.push_back(position);
+                }
+                if (placed) {
+                    displacements[bucket] = displacement;
+                    for (size_t i = 0; i < positions.size(); ++i) {
+                        uint32_t key = buckets[bucket][i];
+                        slots[positions[i]] = {key, static_cast<uint32_t>(entries.at(key))};
+                    }
+                }
+            }
+            if (!placed) {
+                found = false;
+                break;
+            }
+        }
+    }
+    if (!found) {
+        return "";
+    }
+    
+    std::string strings;
+    std::vector<PciDriverDatabase::Branch> branchTable;
+    for (const auto& branch : branchPackages) {
+        std::string list;
+        for (const auto& package : branch.second) {
+            list += (list.empty() ? "" : " ") + package;
+        }
+        branchTable.push_back({static_cast<uint32_t>(branch.first), static_cast<uint32_t>(strings.size()),
+                               static_cast<uint32_t>(list.size())});
+        strings += list;
+    }
+    
+    PciDriverDatabase::Header header;
+    std::memcpy(header.magic, databaseMagic, sizeof(header.magic));
+    header.version = PciDriverDatabase::formatVersion;
+    header.seed = seed;
+    header.bucketCount = bucketCount;
+    header.slotCount = slotCount;
+    header.branchCount = static_cast<uint32_t>(branchTable.size());
+    header.stringsSize = static_cast<uint32_t>(strings.size());
+    
+    std::string output;
+    appendRaw(output, header);
+    for (uint32_t displacement : displacements) {
+        appendRaw(output, displacement);
+    }
+    for (const auto& slot : slots) {
+        appendRaw(output, slot);
+    }
+    for (const auto& branch : branchTable) {
+        appendRaw(output, branch);
+    }
+    output += strings;
+    return output;
+}
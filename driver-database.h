@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Enumeracja typów sterowników (gałęzi sterownika zalecanej dla urządzenia)
+enum class DriverType : uint8_t {
+    NVIDIA_PROPRIETARY,
+    NVIDIA_LEGACY_470,   // Kepler
+    NVIDIA_LEGACY_390,   // Fermi
+    NVIDIA_OPEN,
+    NVIDIA_NOUVEAU,      // Curie i Tesla: brak wspieranego sterownika własnościowego
+    AMD_PROPRIETARY,
+    AMD_OPEN,
+    INTEL_OPEN,
+    GENERIC,
+    UNKNOWN
+};
+
+// Nazwa typu w pliku źródłowym bazy (np. NVIDIA_LEGACY_470)
+std::string driverTypeName(DriverType type);
+bool parseDriverType(const std::string& name, DriverType& type);
+
+// Skrót używany przez bazę: kubełek z ziarnem bazy, pozycja z przesunięciem kubełka
+uint32_t pciDatabaseHash(uint32_t key, uint32_t seed);
+
+// Baza identyfikatorów PCI -> gałąź sterownika w formacie binarnym, mapowana do pamięci.
+// Wyszukiwanie to dwa skróty i jedno porównanie (doskonały skrót "hash and displace"),
+// niezależnie od liczby identyfikatorów; nic nie jest wczytywane ani budowane przy starcie.
+class PciDriverDatabase {
+public:
+    // Nagłówek pliku; za nim przesunięcia kubełków, pozycje, gałęzie i napisy
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t seed;
+        uint32_t bucketCount;
+        uint32_t slotCount;
+        uint32_t branchCount;
+        uint32_t stringsSize;
+    };
+    
+    struct Slot {
+        uint32_t key;        // (producent << 16) | urządzenie; emptyKey: wolna pozycja
+        uint32_t type;
+    };
+    
+    struct Branch {
+        uint32_t type;
+        uint32_t offset;     // Lista pakietów oddzielonych spacjami w tablicy napisów
+        uint32_t length;
+    };
+    
+    static constexpr uint32_t formatVersion = 1;
+    static constexpr uint32_t emptyKey = 0xffffffff;
+    static constexpr uint16_t vendorDefaultDevice = 0xffff;  // Identyfikator nieużywany w PCI
+
+private:
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+    const Header* header = nullptr;
+    const uint32_t* displacements = nullptr;
+    const Slot* slots = nullptr;
+    const Branch* branches = nullptr;
+    const char* strings = nullptr;
+
+public:
+    PciDriverDatabase() = default;
+    ~PciDriverDatabase();
+    PciDriverDatabase(const PciDriverDatabase&) = delete;
+    PciDriverDatabase& operator=(const PciDriverDatabase&) = delete;
+    
+    // Zmapowanie pliku i sprawdzenie nagłówka oraz rozmiarów tablic
+    bool open(const std::string& path);
+    bool isOpen() const {
+        return header != nullptr;
+    }
+    
+    // Gałąź dla dokładnego identyfikatora urządzenia
+    bool lookupDevice(uint16_t vendorId, uint16_t deviceId, DriverType& type) const;
+    
+    // Gałąź domyślna producenta (wpis vendor w pliku źródłowym)
+    bool lookupVendor(uint16_t vendorId, DriverType& type) const;
+    
+    // Pakiety gałęzi (false, jeśli baza ich nie definiuje)
+    bool packages(DriverType type, std::vector<std::string>& result) const;
+    
+    size_t slotCount() const {
+        return header ? header->slotCount : 0;
+    }
+
+private:
+    bool lookupKey(uint32_t key, DriverType& type) const;
+    void close();
+};
+
+// Budowanie pliku bazy (używane przez generator pci-db-compiler przy kompilacji)
+class PciDriverDatabaseBuilder {
+private:
+    std::map<uint32_t, DriverType> entries;
+    std::map<DriverType, std::vector<std::string>> branchPackages;
+
+public:
+    void addDevice(uint16_t vendorId, uint16_t deviceId, DriverType type);
+    void addVendorDefault(uint16_t vendorId, DriverType type);
+    void setPackages(DriverType type, std::vector<std::string> packages);
+    
+    // Wczytanie pliku źródłowego (pci-driver-db.txt); błąd opisuje numer linii
+    bool parseSource(const std::string& text, std::string& error);
+    
+    // Zawartość pliku binarnego; pusty ciąg, jeśli nie udało się znaleźć doskonałego skrótu
+    std::string build() const;
+    
+    size_t size() const {
+        return entries.size();
+    }
+};
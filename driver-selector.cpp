@@ -0,0 +1,70 @@
+#include "driver-selector.h"
+
+#include <map>
+#include <utility>
+
+DriverSelector::DriverSelector(std::shared_ptr<const PciDriverDatabase> database)
+    : database(std::move(database)) {
+}
+
+DriverSelection DriverSelector::select(uint16_t vendorId, uint16_t deviceId) const {
+    DriverSelection selection;
+    selection.vendor = vendorName(vendorId);
+    
+    if (hasDatabase()) {
+        selection.fromDatabase = database->lookupDevice(vendorId, deviceId, selection.type);
+        if (!selection.fromDatabase && !database->lookupVendor(vendorId, selection.type)) {
+            selection.type = DriverType::UNKNOWN;
+        }
+    } else if (selection.vendor == "NVIDIA") {
+        selection.type = DriverType::NVIDIA_PROPRIETARY;
+    } else if (selection.vendor == "AMD") {
+        selection.type = DriverType::AMD_OPEN;
+    } else if (selection.vendor == "Intel") {
+        selection.type = DriverType::INTEL_OPEN;
+    }
+    
+    selection.packages = packagesFor(selection.type);
+    return selection;
+}
+
+std::vector<std::string> DriverSelector::packagesFor(DriverType type) const {
+    std::vector<std::string> packages;
+    if (hasDatabase() && database->packages(type, packages)) {
+        return packages;
+    }
+    
+    // Wbudowane listy na wypadek braku pliku bazy (np. uruchomienie z katalogu budowania)
+    static const std::map<DriverType, std::vector<std::string>> defaults = {
+        {DriverType::NVIDIA_PROPRIETARY, {"akmod-nvidia", "xorg-x11-drv-nvidia", "xorg-x11-drv-nvidia-cuda"}},
+        {DriverType::NVIDIA_LEGACY_470, {"akmod-nvidia-470xx", "xorg-x11-drv-nvidia-470xx", "xorg-x11-drv-nvidia-470xx-cuda"}},
+        {DriverType::NVIDIA_LEGACY_390, {"akmod-nvidia-390xx", "xorg-x11-drv-nvidia-390xx", "xorg-x11-drv-nvidia-390xx-cuda"}},
+        {DriverType::NVIDIA_NOUVEAU, {"mesa-dri-drivers", "mesa-libGL", "xorg-x11-drv-nouveau"}},
+        {DriverType::AMD_OPEN, {"mesa-dri-drivers", "mesa-libGL", "mesa-vulkan-drivers", "xorg-x11-drv-amdgpu"}},
+        {DriverType::INTEL_OPEN, {"mesa-dri-drivers", "mesa-libGL", "xorg-x11-drv-intel"}}
+    };
+    auto it = defaults.find(type);
+    return it == defaults.end() ? std::vector<std::string>() : it->second;
+}
+
+bool DriverSelector::requiresRpmFusion(DriverType type) {
+    return requiresAkmod(type);
+}
+
+bool DriverSelector::requiresAkmod(DriverType type) {
+    return type == DriverType::NVIDIA_PROPRIETARY || type == DriverType::NVIDIA_LEGACY_470 ||
+           type == DriverType::NVIDIA_LEGACY_390 || type == DriverType::NVIDIA_OPEN;
+}
+
+std::string DriverSelector::vendorName(uint16_t vendorId) {
+    switch (vendorId) {
+    case 0x10de:
+        return "NVIDIA";
+    case 0x1002:
+        return "AMD";
+    case 0x8086:
+        return "Intel";
+    default:
+        return "Unknown";
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "driver-database.h"
+
+// Zalecany sterownik dla urządzenia
+struct DriverSelection {
+    std::string vendor = "Unknown";     // NVIDIA, AMD, Intel lub Unknown
+    DriverType type = DriverType::UNKNOWN;
+    std::vector<std::string> packages;
+    bool fromDatabase = false;          // false: domyślny wybór dla producenta (brak bazy lub wpisu)
+};
+
+// Wybór gałęzi sterownika i pakietów: najpierw dokładny identyfikator w bazie PCI,
+// potem wpis domyślny producenta w bazie, a bez bazy wbudowane ustawienia producenta
+class DriverSelector {
+private:
+    std::shared_ptr<const PciDriverDatabase> database;
+
+public:
+    explicit DriverSelector(std::shared_ptr<const PciDriverDatabase> database = nullptr);
+    
+    DriverSelection select(uint16_t vendorId, uint16_t deviceId) const;
+    
+    // Pakiety gałęzi z bazy albo z wbudowanej listy
+    std::vector<std::string> packagesFor(DriverType type) const;
+    
+    bool hasDatabase() const {
+        return database && database->isOpen();
+    }
+    
+    // Czy pakiety gałęzi pochodzą z RPM Fusion
+    static bool requiresRpmFusion(DriverType type);
+    
+    // Czy gałąź wymaga modułu jądra budowanego przez akmods
+    static bool requiresAkmod(DriverType type);
+    
+    static std::string vendorName(uint16_t vendorId);
+};
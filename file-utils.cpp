@@ -0,0 +1,104 @@
+#include "file-utils.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+// Dla operacji na plikach
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
+
+std::string readFileContents(const std::string& path) {
+    std::string result;
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return result;
+    }
+    
+    char buffer[4096];
+    ssize_t count;
+    while ((count = read(fd, buffer, sizeof(buffer))) > 0) {
+        result.append(buffer, static_cast<size_t>(count));
+    }
+    
+    close(fd);
+    return result;
+}
+
+std::string readFirstLine(const std::string& path) {
+    // Atrybuty sysfs mieszczą się w jednej stronie pamięci, wystarczy jeden odczyt
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return "";
+    }
+    
+    char buffer[256];
+    ssize_t count = read(fd, buffer, sizeof(buffer));
+    close(fd);
+    if (count <= 0) {
+        return "";
+    }
+    
+    std::string line(buffer, static_cast<size_t>(count));
+    auto newline = line.find('\n');
+    if (newline != std::string::npos) {
+        line.erase(newline);
+    }
+    while (!line.empty() && (line.back() == ' ' || line.back() == '\t' || line.back() == '\r')) {
+        line.pop_back();
+    }
+    return line;
+}
+
+bool readHexAttribute(const std::string& path, unsigned long& value) {
+    std::string text = readFirstLine(path);
+    if (text.empty()) {
+        return false;
+    }
+    
+    char* end = nullptr;
+    value = std::strtoul(text.c_str(), &end, 16);
+    return end != text.c_str();
+}
+
+std::string readLinkBasename(const std::string& path) {
+    char target[PATH_MAX];
+    ssize_t length = readlink(path.c_str(), target, sizeof(target) - 1);
+    if (length <= 0) {
+        return "";
+    }
+    
+    std::string link(target, static_cast<size_t>(length));
+    auto slash = link.rfind('/');
+    return slash == std::string::npos ? link : link.substr(slash + 1);
+}
+
+bool writeFileAtomically(const std::string& path, const std::string& contents) {
+    std::string temporary = path + ".tmp." + std::to_string(getpid());
+    int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    
+    size_t written = 0;
+    while (written < contents.size()) {
+        ssize_t count = write(fd, contents.data() + written, contents.size() - written);
+        if (count <= 0) {
+            close(fd);
+            unlink(temporary.c_str());
+            return false;
+        }
+        written += static_cast<size_t>(count);
+    }
+    
+    if (fsync(fd) != 0 || close(fd) != 0) {
+        unlink(temporary.c_str());
+        return false;
+    }
+    
+    if (rename(temporary.c_str(), path.c_str()) != 0) {
+        unlink(temporary.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+
+// Pomocnicze funkcje do odczytu plików sysfs/procfs bez uruchamiania procesów
+
+// Odczytanie całej zawartości pliku (pusty ciąg, jeśli pliku nie da się otworzyć)
+std::string readFileContents(const std::string& path);
+
+// Odczytanie pierwszej linii pliku bez końcowych białych znaków
+std::string readFirstLine(const std::string& path);
+
+// Odczytanie atrybutu liczbowego w formacie szesnastkowym (np. "0x10de")
+bool readHexAttribute(const std::string& path, unsigned long& value);
+
+// Nazwa pliku, na który wskazuje dowiązanie symboliczne (pusty ciąg, jeśli to nie dowiązanie)
+std::string readLinkBasename(const std::string& path);
+
+// Zapis pliku przez plik tymczasowy i rename (czytelnik widzi starą albo nową zawartość)
+bool writeFileAtomically(const std::string& path, const std::string& contents);
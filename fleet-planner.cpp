@@ -0,0 +1,186 @@
+#include "fleet-planner.h"
+#include "file-utils.h"
+#include "json-utils.h"
+#include "work-stealing-pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string jsonList(const std::vector<std::string>& values) {
+    std::string result = "[";
+    for (size_t i = 0; i < values.size(); ++i) {
+        result += (i ? ", \"" : "\"") + escapeJson(values[i]) + "\"";
+    }
+    return result + "]";
+}
+
+std::string jsonCounts(const std::map<std::string, size_t>& counts, const std::string& indent) {
+    std::string result = "{";
+    bool first = true;
+    for (const auto& entry : counts) {
+        result += (first ? "\n" : ",\n") + indent + "  \"" + escapeJson(entry.first) + "\": " + std::to_string(entry.second);
+        first = false;
+    }
+    return result + (first ? "}" : "\n" + indent + "}");
+}
+
+// Nazwa pliku planu: nazwa migawki bez rozszerzenia .txt/.lspci
+std::string planName(const fs::path& path) {
+    std::string extension = path.extension().string();
+    return extension == ".txt" || extension == ".lspci" ? path.stem().string() : path.filename().string();
+}
+
+}
+
+FleetPlanner::FleetPlanner(const DriverSelector& selector, std::string outputDir, size_t threads,
+                           const PciNames* names)
+    : selector(selector), outputDir(std::move(outputDir)), threads(threads), names(names) {
+}
+
+FleetSummary FleetPlanner::run(const std::string& inputDir) {
+    auto start = std::chrono::steady_clock::now();
+    FleetSummary summary;
+    
+    std::vector<fs::path> machines;
+    std::error_code error;
+    for (fs::directory_iterator it(inputDir, error), end; !error && it != end; it.increment(error)) {
+        // Katalog wyjściowy wewnątrz inwentarza nie jest maszyną
+        bool isOutput = fs::equivalent(it->path(), outputDir, error);
+        if (it->path().filename().string()[0] != '.' && !isOutput) {
+            machines.push_back(it->path());
+        }
+    }
+    std::sort(machines.begin(), machines.end());
+    fs::create_directories(outputDir, error);
+    
+    // Każdy wątek zapisuje plan swojej maszyny; do podsumowania trafiają tylko wyniki
+    std::vector<MachinePlan> plans(machines.size());
+    WorkStealingPool pool(threads);
+    pool.parallelFor(machines.size(), [&](size_t index) {
+        plans[index] = planMachine(machines[index].string());
+        
+        // Bez fsync: plany można odtworzyć, a tysiące synchronizacji zdominowałyby czas
+        std::ofstream(outputDir + "/" + plans[index].name + ".json") << planJson(plans[index]);
+    });
+    
+    summary.machines = plans.size();
+    for (const auto& plan : plans) {
+        if (!plan.error.empty()) {
+            ++summary.failed;
+            continue;
+        }
+        for (const auto& package : plan.selection.plan.packages()) {
+            ++summary.packageHistogram[package];
+        }
+        for (const auto& device : plan.devices) {
+            ++summary.driverTypes[driverTypeName(device.driverType)];
+        }
+    }
+    summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    writeFileAtomically(outputDir + "/package-histogram.json", summaryJson(summary));
+    return summary;
+}
+
+MachinePlan FleetPlanner::planMachine(const std::string& path) const {
+    MachinePlan plan;
+    plan.name = planName(path);
+    
+    std::error_code error;
+    std::vector<PciDevice> controllers;
+    std::unique_ptr<DriverResolver> resolver;
+    
+    if (fs::is_directory(path, error)) {
+        // Drzewo sysfs z ewentualnym procfs obok, tak jak drzewa testowe benchmarku
+        std::string sysfsRoot = fs::exists(path + "/sys/bus/pci", error) ? path + "/sys" : path;
+        std::string procRoot = path + "/proc";
+        plan.source = "sysfs";
+        if (!fs::exists(sysfsRoot + "/bus/pci/devices", error)) {
+            plan.error = "brak katalogu bus/pci/devices";
+            return plan;
+        }
+        controllers = PciScanner(sysfsRoot).scanDisplayControllers();
+        resolver = std::make_unique<DriverResolver>(sysfsRoot,
+            std::make_shared<KernelModuleTable>(KernelModuleTable::load(procRoot)));
+    } else {
+        plan.source = "lspci";
+        controllers = PciScanner::parseLspciOutput(readFileContents(path));
+        controllers.erase(std::remove_if(controllers.begin(), controllers.end(), [](const PciDevice& device) {
+            return !device.isDisplayController();
+        }), controllers.end());
+    }
+    
+    if (controllers.empty()) {
+        plan.error = "brak kontrolerów wyświetlania";
+        return plan;
+    }
+    
+    // Ta sama logika co wykrywanie i wybór pakietów instalatora; RPM Fusion zostałoby włączone
+    plan.devices = describeGraphicsDevices(controllers, selector, resolver.get(), names);
+    plan.selection = selectInstallation(plan.devices, selector, true);
+    for (size_t index : plan.selection.plannedDevices) {
+        plan.akmodBuild = plan.akmodBuild || DriverSelector::requiresAkmod(plan.devices[index].driverType);
+    }
+    return plan;
+}
+
+std::string FleetPlanner::planJson(const MachinePlan& plan) {
+    std::ostringstream json;
+    json << "{\n";
+    json << "  \"machine\": \"" << escapeJson(plan.name) << "\",\n";
+    json << "  \"source\": \"" << plan.source << "\",\n";
+    if (!plan.error.empty()) {
+        json << "  \"error\": \"" << escapeJson(plan.error) << "\"\n}\n";
+        return json.str();
+    }
+    
+    const InstallSelection& selection = plan.selection;
+    json << "  \"devices\": [";
+    for (size_t i = 0; i < plan.devices.size(); ++i) {
+        const GraphicsDevice& device = plan.devices[i];
+        bool planned = std::find(selection.plannedDevices.begin(), selection.plannedDevices.end(), i) !=
+                       selection.plannedDevices.end();
+        json << (i ? "," : "") << "\n    {";
+        json << "\"slot\": \"" << escapeJson(device.busId) << "\", ";
+        json << "\"pci_id\": \"" << device.pciId << "\", ";
+        json << "\"vendor\": \"" << escapeJson(device.vendor) << "\", ";
+        json << "\"model\": \"" << escapeJson(device.model) << "\", ";
+        json << "\"primary\": " << (device.isPrimary ? "true" : "false") << ", ";
+        json << "\"current_driver\": \"" << escapeJson(device.currentDriver) << "\", ";
+        json << "\"driver_type\": \"" << driverTypeName(device.driverType) << "\", ";
+        json << "\"from_database\": " << (device.driverFromDatabase ? "true" : "false") << ", ";
+        json << "\"action\": \"" << (planned ? "install" : "skip") << "\"}";
+    }
+    json << "\n  ],\n";
+    
+    bool rpmFusion = false;
+    for (size_t index : selection.plannedDevices) {
+        rpmFusion = rpmFusion || DriverSelector::requiresRpmFusion(plan.devices[index].driverType);
+    }
+    json << "  \"requires_rpmfusion\": " << (rpmFusion ? "true" : "false") << ",\n";
+    json << "  \"akmod_build\": " << (plan.akmodBuild ? "true" : "false") << ",\n";
+    json << "  \"packages\": " << jsonList(selection.plan.packages()) << ",\n";
+    json << "  \"duplicate_packages\": " << selection.plan.duplicateCount() << "\n";
+    json << "}\n";
+    return json.str();
+}
+
+std::string FleetPlanner::summaryJson(const FleetSummary& summary) {
+    std::ostringstream json;
+    json << "{\n";
+    json << "  \"machines\": " << summary.machines << ",\n";
+    json << "  \"failed\": " << summary.failed << ",\n";
+    json << "  \"packages\": " << jsonCounts(summary.packageHistogram, "  ") << ",\n";
+    json << "  \"driver_types\": " << jsonCounts(summary.driverTypes, "  ") << "\n";
+    json << "}\n";
+    return json.str();
+}
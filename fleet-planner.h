@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "driver-selector.h"
+#include "graphics-device.h"
+#include "pci-names.h"
+
+// Plan instalacji dla jednej maszyny z inwentarza
+struct MachinePlan {
+    std::string name;                     // Nazwa katalogu lub pliku migawki
+    std::string source;                   // sysfs lub lspci
+    std::string error;                    // Pusty, jeśli migawkę udało się odczytać
+    std::vector<GraphicsDevice> devices;
+    InstallSelection selection;
+    bool akmodBuild = false;              // Czy instalacja czekałaby na moduł budowany przez akmods
+};
+
+// Podsumowanie całego inwentarza
+struct FleetSummary {
+    size_t machines = 0;
+    size_t failed = 0;                               // Migawki nieczytelne lub bez kart graficznych
+    std::map<std::string, size_t> packageHistogram;  // Pakiet -> liczba maszyn
+    std::map<std::string, size_t> driverTypes;       // Gałąź sterownika -> liczba urządzeń
+    double seconds = 0;
+};
+
+// Planowanie instalacji dla wielu migawek sprzętu bez uprawnień roota i bez zmian w systemie.
+// Każdy wpis katalogu wejściowego to jedna maszyna: katalog z drzewem sysfs
+// (<maszyna>/sys/bus/pci lub <maszyna>/bus/pci, opcjonalnie <maszyna>/proc/modules)
+// albo plik z wyjściem lspci -nn. Plany powstają na puli wątków z podkradaniem zadań.
+class FleetPlanner {
+private:
+    const DriverSelector& selector;
+    std::string outputDir;
+    size_t threads;
+    const PciNames* names;       // Nazwy modeli z pci.ids (może być nullptr)
+
+public:
+    FleetPlanner(const DriverSelector& selector, std::string outputDir, size_t threads,
+                 const PciNames* names = nullptr);
+    
+    // Zapis <wyjście>/<maszyna>.json dla każdej maszyny i <wyjście>/package-histogram.json
+    FleetSummary run(const std::string& inputDir);
+    
+    MachinePlan planMachine(const std::string& path) const;
+    
+    static std::string planJson(const MachinePlan& plan);
+    static std::string summaryJson(const FleetSummary& summary);
+};
@@ -0,0 +1,73 @@
+#include "graphics-device.h"
+
+#include <map>
+
+std::vector<GraphicsDevice> describeGraphicsDevices(const std::vector<PciDevice>& controllers,
+                                                    const DriverSelector& selector,
+                                                    const DriverResolver* resolver,
+                                                    const PciNames* names) {
+    // Moduły, które mogą obsługiwać karty danego producenta
+    static const std::map<std::string, std::vector<std::string>> candidateModules = {
+        {"NVIDIA", {"nvidia", "nouveau"}},
+        {"AMD", {"amdgpu", "radeon"}},
+        {"Intel", {"i915", "xe"}}
+    };
+    
+    bool anyBootVga = false;
+    for (const auto& controller : controllers) {
+        anyBootVga = anyBootVga || controller.bootVga;
+    }
+    
+    std::vector<GraphicsDevice> devices;
+    devices.reserve(controllers.size());
+    for (const auto& controller : controllers) {
+        GraphicsDevice device;
+        device.pciId = PciScanner::formatId(controller.vendorId, controller.deviceId);
+        device.busId = controller.slot;
+        
+        // Producent i zalecana gałąź sterownika (O(1) w bazie PCI)
+        DriverSelection selection = selector.select(controller.vendorId, controller.deviceId);
+        device.vendor = selection.vendor;
+        device.driverType = selection.type;
+        device.driverFromDatabase = selection.fromDatabase;
+        
+        device.model = names ? names->lookup(controller.vendorId, controller.deviceId) : "";
+        if (device.model.empty()) {
+            device.model = controller.description.empty() ? PciScanner::className(controller.classCode)
+                                                          : controller.description;
+        }
+        device.isPrimary = anyBootVga ? controller.bootVga : devices.empty();
+        device.numaNode = controller.numaNode;
+        
+        // Sterownik z dowiązania w sysfs, a bez niego załadowany moduł kandydujący
+        if (!resolver) {
+            device.currentDriver = "unknown";
+        } else {
+            auto it = candidateModules.find(device.vendor);
+            device.currentDriver = it == candidateModules.end() ? resolver->resolve(device.busId)
+                                                                : resolver->resolve(device.busId, it->second);
+        }
+        
+        devices.push_back(device);
+    }
+    return devices;
+}
+
+InstallSelection selectInstallation(const std::vector<GraphicsDevice>& devices, const DriverSelector& selector,
+                                    bool rpmFusionEnabled) {
+    InstallSelection selection;
+    for (size_t i = 0; i < devices.size(); ++i) {
+        const GraphicsDevice& device = devices[i];
+        std::vector<std::string> packages = selector.packagesFor(device.driverType);
+        
+        if (packages.empty()) {
+            selection.unknownDevices.push_back(i);
+        } else if (DriverSelector::requiresRpmFusion(device.driverType) && !rpmFusionEnabled) {
+            selection.blockedDevices.push_back(i);
+        } else {
+            selection.plan.addDevice(device.vendor + " " + device.model, packages);
+            selection.plannedDevices.push_back(i);
+        }
+    }
+    return selection;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "driver-selector.h"
+#include "kernel-modules.h"
+#include "pci-names.h"
+#include "pci-scanner.h"
+#include "transaction-plan.h"
+
+// Struktura przechowująca informacje o urządzeniu graficznym
+struct GraphicsDevice {
+    std::string pciId;        // ID urządzenia PCI (np. 10de:1234)
+    std::string busId;        // Adres PCI w formacie BDF (np. 0000:01:00.0)
+    std::string vendor;       // Nazwa producenta (NVIDIA, AMD, Intel)
+    std::string model;        // Model karty graficznej
+    std::string currentDriver; // Aktualnie używany sterownik
+    bool isPrimary;           // Czy to główna karta graficzna
+    int numaNode = -1;        // Węzeł NUMA karty (-1: nieznany)
+    DriverType driverType = DriverType::UNKNOWN; // Zalecana gałąź sterownika
+    bool driverFromDatabase = false; // Czy gałąź wskazał wpis bazy PCI dla tego urządzenia
+};
+
+// Opis kontrolerów wyświetlania: producent, zalecana gałąź i karta główna (boot_vga,
+// a bez niego pierwsza wykryta). Bez resolvera aktualny sterownik jest nieznany.
+// Model pochodzi z pci.ids, a bez wpisu z opisu lspci lub nazwy klasy kontrolera.
+std::vector<GraphicsDevice> describeGraphicsDevices(const std::vector<PciDevice>& controllers,
+                                                    const DriverSelector& selector,
+                                                    const DriverResolver* resolver = nullptr,
+                                                    const PciNames* names = nullptr);
+
+// Wybór urządzeń i pakietów do instalacji, wspólny dla instalacji i planowania
+struct InstallSelection {
+    TransactionPlan plan;                 // Jedna transakcja dla wszystkich urządzeń
+    std::vector<size_t> plannedDevices;   // Urządzenia w planie (kolejność wpisów planu)
+    std::vector<size_t> unknownDevices;   // Brak sterowników dla producenta
+    std::vector<size_t> blockedDevices;   // Wymagają RPM Fusion, które nie jest włączone
+};
+
+InstallSelection selectInstallation(const std::vector<GraphicsDevice>& devices, const DriverSelector& selector,
+                                    bool rpmFusionEnabled);
@@ -0,0 +1,118 @@
+#include "hardware-fingerprint.h"
+#include "file-utils.h"
+
+#include <algorithm>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace {
+
+const char* const FINGERPRINT_HEADER = "fingerprint\t1";
+
+std::vector<std::string> splitFields(const std::string& line) {
+    std::vector<std::string> fields;
+    std::istringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, '\t')) {
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+}
+
+bool FingerprintDevice::operator==(const FingerprintDevice& other) const {
+    return slot == other.slot && pciId == other.pciId && driverType == other.driverType;
+}
+
+bool FingerprintChanges::any() const {
+    return kernel || packageDb || !changedSlots.empty() || !removedSlots.empty();
+}
+
+FingerprintChanges compareFingerprints(const HardwareFingerprint& previous, const HardwareFingerprint& current) {
+    FingerprintChanges changes;
+    changes.kernel = previous.kernelRelease != current.kernelRelease;
+    changes.packageDb = previous.packageDbStamp != current.packageDbStamp;
+    
+    // Obie listy są posortowane według adresu
+    auto before = previous.devices.begin();
+    auto after = current.devices.begin();
+    while (before != previous.devices.end() || after != current.devices.end()) {
+        if (after == current.devices.end() || (before != previous.devices.end() && before->slot < after->slot)) {
+            changes.removedSlots.push_back((before++)->slot);
+        } else if (before == previous.devices.end() || after->slot < before->slot) {
+            changes.changedSlots.push_back((after++)->slot);
+        } else {
+            if (*before != *after) {
+                changes.changedSlots.push_back(after->slot);
+            }
+            ++before;
+            ++after;
+        }
+    }
+    return changes;
+}
+
+std::string packageDatabaseStamp(const std::vector<std::string>& candidates) {
+    for (const auto& path : candidates) {
+        struct stat info;
+        if (stat(path.c_str(), &info) == 0) {
+            return std::to_string(info.st_mtim.tv_sec) + "." + std::to_string(info.st_mtim.tv_nsec) + ":" +
+                   std::to_string(info.st_size);
+        }
+    }
+    return "-";
+}
+
+FingerprintStore::FingerprintStore(std::string path) : path(std::move(path)) {
+}
+
+bool FingerprintStore::load(HardwareFingerprint& fingerprint) const {
+    std::istringstream stream(readFileContents(path));
+    std::string line;
+    if (!std::getline(stream, line) || line != FINGERPRINT_HEADER) {
+        return false;
+    }
+    
+    HardwareFingerprint loaded;
+    while (std::getline(stream, line)) {
+        std::vector<std::string> fields = splitFields(line);
+        if (fields.size() == 2 && fields[0] == "kernel") {
+            loaded.kernelRelease = fields[1];
+        } else if (fields.size() == 2 && fields[0] == "rpmdb") {
+            loaded.packageDbStamp = fields[1];
+        } else if (fields.size() == 4 && fields[0] == "device") {
+            FingerprintDevice device{fields[1], fields[2], DriverType::UNKNOWN};
+            parseDriverType(fields[3], device.driverType);
+            loaded.devices.push_back(device);
+        } else if (fields.size() == 3 && fields[0] == "package") {
+            loaded.packages[fields[1]] = fields[2];
+        } else if (!line.empty()) {
+            return false;
+        }
+    }
+    std::sort(loaded.devices.begin(), loaded.devices.end(), [](const FingerprintDevice& a, const FingerprintDevice& b) {
+        return a.slot < b.slot;
+    });
+    fingerprint = std::move(loaded);
+    return true;
+}
+
+bool FingerprintStore::save(const HardwareFingerprint& fingerprint) const {
+    std::string contents = std::string(FINGERPRINT_HEADER) + "\n";
+    contents += "kernel\t" + fingerprint.kernelRelease + "\n";
+    contents += "rpmdb\t" + fingerprint.packageDbStamp + "\n";
+    for (const auto& device : fingerprint.devices) {
+        contents += "device\t" + device.slot + "\t" + device.pciId + "\t" + driverTypeName(device.driverType) + "\n";
+    }
+    for (const auto& package : fingerprint.packages) {
+        contents += "package\t" + package.first + "\t" + package.second + "\n";
+    }
+    return writeFileAtomically(path, contents);
+}
+
+void FingerprintStore::clear() const {
+    unlink(path.c_str());
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "driver-database.h"
+
+// Karta graficzna w odcisku: adres, identyfikator i wybrana gałąź sterownika
+struct FingerprintDevice {
+    std::string slot;
+    std::string pciId;
+    DriverType driverType = DriverType::UNKNOWN;
+    
+    bool operator==(const FingerprintDevice& other) const;
+    bool operator!=(const FingerprintDevice& other) const { return !(*this == other); }
+};
+
+// Stan systemu po ostatnim udanym przebiegu instalatora
+struct HardwareFingerprint {
+    std::string kernelRelease;
+    std::string packageDbStamp;                   // Czas modyfikacji i rozmiar bazy rpm ("-": brak bazy)
+    std::vector<FingerprintDevice> devices;       // Posortowane według adresu
+    std::map<std::string, std::string> packages;  // Pakiet sterownika -> zainstalowana wersja
+};
+
+// Różnice między zapisanym a bieżącym odciskiem
+struct FingerprintChanges {
+    bool kernel = false;                     // Inne jądro (moduły akmods trzeba zbudować ponownie)
+    bool packageDb = false;                  // Baza rpm zmieniła się od ostatniego przebiegu
+    std::vector<std::string> changedSlots;   // Nowe karty lub karty o innym identyfikatorze/gałęzi
+    std::vector<std::string> removedSlots;   // Karty, których już nie ma
+    
+    bool any() const;
+};
+
+FingerprintChanges compareFingerprints(const HardwareFingerprint& previous, const HardwareFingerprint& current);
+
+// Znacznik bazy rpm bez jej czytania: st_mtim i rozmiar pierwszego istniejącego pliku
+std::string packageDatabaseStamp(const std::vector<std::string>& candidates);
+
+// Odcisk zapisany w jednym pliku tekstowym (wiersze rozdzielane tabulatorami)
+class FingerprintStore {
+private:
+    std::string path;
+
+public:
+    explicit FingerprintStore(std::string path);
+    
+    // false, jeśli pliku nie ma lub ma nieznany format
+    bool load(HardwareFingerprint& fingerprint) const;
+    bool save(const HardwareFingerprint& fingerprint) const;
+    void clear() const;
+    
+    const std::string& filePath() const { return path; }
+};
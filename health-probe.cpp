@@ -0,0 +1,155 @@
+#include "health-probe.h"
+#include "file-utils.h"
+
+#include <algorithm>
+#include <cctype>
+#include <utility>
+
+// Dla operacji na katalogach
+#include <dirent.h>
+
+namespace {
+
+// Nazwy wpisów katalogu (bez . i ..)
+std::vector<std::string> listDirectory(const std::string& path) {
+    std::vector<std::string> names;
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        return names;
+    }
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') {
+            names.push_back(entry->d_name);
+        }
+    }
+    closedir(dir);
+    return names;
+}
+
+bool isNumeric(const char* text) {
+    if (!*text) {
+        return false;
+    }
+    for (; *text; ++text) {
+        if (!std::isdigit(static_cast<unsigned char>(*text))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+bool HealthReport::healthy() const {
+    bool displayActive = !displayServers.empty();
+    for (const auto& gpu : gpus) {
+        if (!gpu.healthy) {
+            return false;
+        }
+        displayActive = displayActive || gpu.enabled > 0;
+    }
+    return displayActive;
+}
+
+HealthProbe::HealthProbe(HealthProbeOptions options) : options(std::move(options)) {
+    // Jądro obcina comm do 15 znaków, więc dłuższe nazwy są porównywane po obcięciu
+    for (auto& name : this->options.displayServers) {
+        name = name.substr(0, 15);
+    }
+}
+
+HealthReport HealthProbe::run(const std::vector<std::string>& slots) const {
+    auto start = std::chrono::steady_clock::now();
+    Deadline deadline = start + options.budget;
+    
+    HealthReport report;
+    bool complete = inspectGpus(deadline, slots, report.gpus);
+    complete = complete && findDisplayServers(deadline, report.displayServers);
+    
+    report.timedOut = !complete;
+    report.duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    return report;
+}
+
+bool HealthProbe::findDisplayServers(Deadline deadline, std::vector<std::string>& found) const {
+    DIR* dir = opendir(options.procRoot.c_str());
+    if (!dir) {
+        return true;
+    }
+    
+    // Jeden przegląd wszystkich procesów dla wszystkich nazw
+    bool complete = true;
+    size_t checked = 0;
+    while (dirent* entry = readdir(dir)) {
+        if (!isNumeric(entry->d_name)) {
+            continue;
+        }
+        if (++checked % 64 == 0 && std::chrono::steady_clock::now() > deadline) {
+            complete = false;
+            break;
+        }
+        
+        std::string comm = readFirstLine(options.procRoot + "/" + entry->d_name + "/comm");
+        bool known = std::find(options.displayServers.begin(), options.displayServers.end(), comm) != options.displayServers.end();
+        if (known && std::find(found.begin(), found.end(), comm) == found.end()) {
+            found.push_back(comm);
+        }
+    }
+    closedir(dir);
+    return complete;
+}
+
+bool HealthProbe::inspectGpus(Deadline deadline, const std::vector<std::string>& slots, std::vector<GpuHealth>& gpus) const {
+    std::string drmRoot = options.sysfsRoot + "/class/drm";
+    std::vector<std::string> entries = listDirectory(drmRoot);
+    std::sort(entries.begin(), entries.end());
+    
+    for (const auto& slot : slots) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        
+        GpuHealth gpu;
+        gpu.slot = slot;
+        gpu.driver = readLinkBasename(options.sysfsRoot + "/bus/pci/devices/" + slot + "/driver");
+        
+        // Karty DRM urządzenia: cardN z dowiązaniem device wskazującym na ten adres PCI
+        for (const auto& entry : entries) {
+            if (entry.compare(0, 4, "card") != 0 || entry.find('-') != std::string::npos) {
+                continue;
+            }
+            if (readLinkBasename(drmRoot + "/" + entry + "/device") != slot) {
+                continue;
+            }
+            gpu.cards.push_back(entry);
+            
+            // Wyjścia karty: cardN-<typ>-<numer> ze stanem status i enabled
+            std::string prefix = entry + "-";
+            for (const auto& connector : entries) {
+                if (connector.compare(0, prefix.size(), prefix) != 0) {
+                    continue;
+                }
+                ++gpu.connectors;
+                std::string path = drmRoot + "/" + connector;
+                gpu.connected += readFirstLine(path + "/status") == "connected";
+                gpu.enabled += readFirstLine(path + "/enabled") == "enabled";
+            }
+        }
+        
+        gpu.healthy = !gpu.driver.empty();
+        if (!gpu.healthy) {
+            gpu.verdict = "brak związanego sterownika";
+        } else if (gpu.cards.empty()) {
+            gpu.verdict = "sterownik " + gpu.driver + " bez karty DRM";
+        } else if (gpu.enabled > 0) {
+            gpu.verdict = "sterownik " + gpu.driver + ", aktywne wyjścia: " + std::to_string(gpu.enabled) + "/" +
+                          std::to_string(gpu.connectors);
+        } else if (gpu.connected > 0) {
+            gpu.verdict = "sterownik " + gpu.driver + ", podłączony wyświetlacz bez obrazu";
+        } else {
+            gpu.verdict = "sterownik " + gpu.driver + ", brak podłączonych wyświetlaczy";
+        }
+        gpus.push_back(gpu);
+    }
+    return true;
+}
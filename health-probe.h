@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Ustawienia sprawdzania stanu grafiki po instalacji sterowników
+struct HealthProbeOptions {
+    std::string procRoot = "/proc";   // Procesy serwerów wyświetlania (/proc/<pid>/comm)
+    std::string sysfsRoot = "/sys";   // Urządzenia PCI i karty DRM (/sys/class/drm)
+    
+    // Serwery X i kompozytory Wayland (nazwy z /proc/<pid>/comm, obcinane przez jądro do 15 znaków)
+    std::vector<std::string> displayServers = {
+        "Xorg", "X", "Xwayland", "gnome-shell", "kwin_wayland", "kwin_x11", "sway", "weston",
+        "mutter", "Hyprland", "wayfire", "labwc", "river", "niri", "cosmic-comp", "gamescope"
+    };
+    
+    std::chrono::milliseconds budget{250};  // Limit czasu całego sprawdzenia
+};
+
+// Stan jednej karty graficznej
+struct GpuHealth {
+    std::string slot;                 // Adres BDF
+    std::string driver;               // Związany sterownik PCI (pusty: brak)
+    std::vector<std::string> cards;   // Karty DRM urządzenia (np. card0)
+    size_t connectors = 0;            // Wyjścia karty
+    size_t connected = 0;             // Wyjścia z podłączonym wyświetlaczem
+    size_t enabled = 0;               // Wyjścia z aktywnym obrazem (CRTC i bufor ramki)
+    bool healthy = false;             // Czy sterownik jest związany z urządzeniem
+    std::string verdict;              // Opis stanu do logów
+};
+
+// Wynik sprawdzenia
+struct HealthReport {
+    std::vector<std::string> displayServers;  // Znalezione działające serwery wyświetlania
+    std::vector<GpuHealth> gpus;
+    bool timedOut = false;                     // Przekroczony budżet: wynik niepełny
+    std::chrono::microseconds duration{0};
+    
+    // Każda karta ma sterownik, a obraz jest wyświetlany (serwer wyświetlania lub aktywne wyjście)
+    bool healthy() const;
+};
+
+// Sprawdzenie stanu grafiki bez uruchamiania procesów: jeden przegląd /proc/*/comm
+// oraz atrybuty kart DRM i urządzeń PCI w sysfs
+class HealthProbe {
+private:
+    HealthProbeOptions options;
+
+public:
+    explicit HealthProbe(HealthProbeOptions options);
+    
+    // Stan podanych kart (adresy BDF) i obecność serwera wyświetlania
+    HealthReport run(const std::vector<std::string>& slots) const;
+
+private:
+    using Deadline = std::chrono::steady_clock::time_point;
+    
+    bool findDisplayServers(Deadline deadline, std::vector<std::string>& found) const;
+    bool inspectGpus(Deadline deadline, const std::vector<std::string>& slots, std::vector<GpuHealth>& gpus) const;
+};
@@ -0,0 +1,221 @@
+#include "install-progress.h"
+#include "json-utils.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <utility>
+
+namespace {
+
+std::string trim(const std::string& text) {
+    size_t start = text.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(start, end - start + 1);
+}
+
+// Licznik kroku "k/n"; false, jeśli tekst ma inny format
+bool parseCounter(const std::string& text, unsigned& done, unsigned& total) {
+    size_t slash = text.find('/');
+    if (slash == std::string::npos || slash == 0 || slash + 1 >= text.size() ||
+        text.find_first_not_of("0123456789/") != std::string::npos) {
+        return false;
+    }
+    done = static_cast<unsigned>(std::strtoul(text.c_str(), nullptr, 10));
+    total = static_cast<unsigned>(std::strtoul(text.c_str() + slash + 1, nullptr, 10));
+    return done > 0 && total >= done;
+}
+
+// Etap transakcji dla czasownika z wyjścia dnf (pusty: linia bez postępu pakietu)
+std::string transactionStage(const std::string& verb) {
+    static const std::map<std::string, std::string> stages = {
+        {"Installing", "install"}, {"Upgrading", "install"}, {"Reinstalling", "install"},
+        {"Downgrading", "install"}, {"Erasing", "remove"}, {"Removing", "remove"},
+        {"Obsoleting", "remove"}, {"Cleanup", "remove"}, {"Verifying", "verify"}
+    };
+    auto it = stages.find(verb);
+    return it == stages.end() ? "" : it->second;
+}
+
+}
+
+std::string progressEventJson(const ProgressEvent& event) {
+    std::ostringstream json;
+    json << "{\"event\":\"" << escapeJson(event.event) << "\"";
+    if (!event.phase.empty()) {
+        json << ",\"phase\":\"" << escapeJson(event.phase) << "\"";
+    }
+    if (!event.package.empty()) {
+        json << ",\"package\":\"" << escapeJson(event.package) << "\"";
+    }
+    if (event.bytes > 0) {
+        json << ",\"bytes\":" << event.bytes;
+    }
+    if (event.percent >= 0) {
+        char percent[16];
+        std::snprintf(percent, sizeof(percent), "%.1f", event.percent);
+        json << ",\"percent\":" << percent;
+    }
+    if (event.etaSeconds >= 0) {
+        json << ",\"eta\":" << event.etaSeconds;
+    }
+    if (!event.message.empty()) {
+        json << ",\"message\":\"" << escapeJson(event.message) << "\"";
+    }
+    if (event.event == "result") {
+        json << ",\"success\":" << (event.success ? "true" : "false");
+    }
+    json << "}\n";
+    return json.str();
+}
+
+DnfProgressParser::DnfProgressParser(Callback callback) : callback(std::move(callback)) {
+    reset();
+}
+
+void DnfProgressParser::reset() {
+    stage.clear();
+    stageStart = Clock::now();
+    lastEvent = stageStart;
+    bytes = 0;
+}
+
+void DnfProgressParser::feed(const std::string& rawLine) {
+    std::string line = trim(rawLine);
+    if (line.size() < 5) {
+        return;
+    }
+    
+    // dnf4, pobieranie: "(1/6): nazwa-wersja.rpm   12 MB/s |  58 MB     00:04"
+    if (line[0] == '(') {
+        size_t close = line.find("): ");
+        unsigned done, total;
+        if (close == std::string::npos || !parseCounter(line.substr(1, close - 1), done, total)) {
+            return;
+        }
+        std::istringstream rest(line.substr(close + 3));
+        std::string package;
+        rest >> package;
+        if (package.size() > 4 && package.compare(package.size() - 4, 4, ".rpm") == 0) {
+            package.erase(package.size() - 4);
+        }
+        
+        size_t bar = line.rfind('|');
+        uint64_t size = 0;
+        if (bar != std::string::npos) {
+            std::istringstream sizeFields(line.substr(bar + 1));
+            std::string number, unit;
+            sizeFields >> number >> unit;
+            if (parseSize(number + " " + unit, size)) {
+                bytes += size;
+            }
+        }
+        report("download", package, done, total);
+        return;
+    }
+    
+    // dnf5: "[1/6] nazwa-wersja  100% | 12.0 MiB/s | 58.0 MiB | 00m05s" (pobieranie)
+    // albo "[3/8] Installing nazwa-wersja  100% | ..." (krok transakcji)
+    if (line[0] == '[') {
+        size_t close = line.find(']');
+        unsigned done, total;
+        if (close == std::string::npos || !parseCounter(trim(line.substr(1, close - 1)), done, total)) {
+            return;
+        }
+        std::istringstream rest(line.substr(close + 1));
+        std::string first;
+        rest >> first;
+        
+        std::string lineStage = transactionStage(first);
+        if (!lineStage.empty()) {
+            std::string package;
+            rest >> package;
+            report(lineStage, package, done, total);
+            return;
+        }
+        
+        // Kroki bez pakietu (Verify package files, Prepare transaction) nie mają znaczenia dla postępu
+        size_t firstBar = line.find('|', close);
+        size_t secondBar = firstBar == std::string::npos ? firstBar : line.find('|', firstBar + 1);
+        if (secondBar == std::string::npos || line.find("100%") == std::string::npos || first.find('-') == std::string::npos) {
+            return;
+        }
+        size_t thirdBar = line.find('|', secondBar + 1);
+        uint64_t size = 0;
+        if (parseSize(trim(line.substr(secondBar + 1, thirdBar == std::string::npos ? std::string::npos
+                                                                                     : thirdBar - secondBar - 1)), size)) {
+            bytes += size;
+        }
+        report("download", first, done, total);
+        return;
+    }
+    
+    // dnf4, transakcja: "Installing       : nazwa-wersja    3/6"
+    size_t colon = line.find(" : ");
+    if (colon == std::string::npos) {
+        return;
+    }
+    std::string lineStage = transactionStage(trim(line.substr(0, colon)));
+    if (lineStage.empty()) {
+        return;
+    }
+    std::istringstream rest(line.substr(colon + 3));
+    std::string package, counter;
+    rest >> package >> counter;
+    unsigned done, total;
+    if (parseCounter(counter, done, total)) {
+        report(lineStage, package, done, total);
+    }
+}
+
+bool DnfProgressParser::parseSize(const std::string& text, uint64_t& result) {
+    std::istringstream fields(text);
+    double value;
+    std::string unit;
+    if (!(fields >> value) || value < 0) {
+        return false;
+    }
+    fields >> unit;
+    
+    // dnf4 podaje jednostki k, M, G (potęgi 1024) z "B" lub bez, dnf5 KiB, MiB, GiB
+    static const std::map<std::string, double> units = {
+        {"", 1}, {"B", 1},
+        {"k", 1024.0}, {"kB", 1024.0}, {"KB", 1024.0}, {"KiB", 1024.0},
+        {"M", 1048576.0}, {"MB", 1048576.0}, {"MiB", 1048576.0},
+        {"G", 1073741824.0}, {"GB", 1073741824.0}, {"GiB", 1073741824.0}
+    };
+    auto it = units.find(unit);
+    if (it == units.end()) {
+        return false;
+    }
+    result = static_cast<uint64_t>(value * it->second);
+    return true;
+}
+
+void DnfProgressParser::report(const std::string& lineStage, const std::string& package, unsigned done, unsigned total) {
+    // Nowy etap (np. pobieranie -> instalacja) ma własny czas i licznik
+    auto now = Clock::now();
+    if (lineStage != stage) {
+        stage = lineStage;
+        stageStart = lastEvent;
+    }
+    lastEvent = now;
+    
+    ProgressEvent event;
+    event.event = "package";
+    event.phase = stage;
+    event.package = package;
+    event.bytes = stage == "download" ? bytes : 0;
+    event.percent = 100.0 * done / total;
+    
+    // Szacunek z dotychczasowego tempa etapu
+    double elapsed = std::chrono::duration<double>(now - stageStart).count();
+    event.etaSeconds = static_cast<int>(elapsed * (total - done) / done + 0.5);
+    if (callback) {
+        callback(event);
+    }
+}
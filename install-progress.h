@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Zdarzenie postępu instalacji dla interfejsu graficznego (jedna linia JSON na gnieździe postępu)
+struct ProgressEvent {
+    std::string event;        // phase, status, package, prompt, answer, result
+    std::string phase;        // detect, download, install, remove, verify, build, configure, test, rollback
+    std::string package;      // Pakiet, którego dotyczy zdarzenie package
+    std::string message;      // Opis dla użytkownika (status, pytanie, wynik)
+    uint64_t bytes = 0;       // Bajty pobrane od początku etapu
+    double percent = -1;      // Postęp etapu w procentach (-1: nieznany)
+    int etaSeconds = -1;      // Szacowany czas do końca etapu (-1: nieznany)
+    bool success = true;      // Wynik instalacji (zdarzenie result)
+};
+
+// Zapis zdarzenia jako jednej linii JSON zakończonej \n; pola nieznane są pomijane
+std::string progressEventJson(const ProgressEvent& event);
+
+// Przyrostowy odczyt postępu z wyjścia dnf4 i dnf5 uruchomionych bez terminala.
+// Każda linia jest analizowana od razu po odczycie i nie jest przechowywana:
+// zakończone pobrania dają nazwę pakietu i rozmiar, kroki transakcji numer k/n.
+class DnfProgressParser {
+public:
+    using Callback = std::function<void(const ProgressEvent& event)>;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    Callback callback;
+    std::string stage;              // Bieżący etap (download, install, remove, verify)
+    Clock::time_point stageStart;
+    Clock::time_point lastEvent;    // Koniec poprzedniego kroku (początek etapu, który po nim następuje)
+    uint64_t bytes = 0;
+
+public:
+    explicit DnfProgressParser(Callback callback);
+    
+    // Początek nowego polecenia dnf
+    void reset();
+    
+    // Jedna linia wyjścia (z \n lub bez)
+    void feed(const std::string& line);
+    
+    // Rozmiar w formacie dnf ("58 MB", "320 k", "12.0 MiB"); false, jeśli to nie rozmiar
+    static bool parseSize(const std::string& text, uint64_t& bytes);
+
+private:
+    void report(const std::string& lineStage, const std::string& package, unsigned done, unsigned total);
+};
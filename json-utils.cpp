@@ -0,0 +1,87 @@
+#include "json-utils.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+std::string escapeJson(const std::string& text) {
+    std::string result;
+    for (char c : text) {
+        switch (c) {
+            case '"':  result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    result += buffer;
+                } else {
+                    result += c;
+                }
+        }
+    }
+    return result;
+}
+
+namespace {
+
+// Pozycja wartości pola (po dwukropku i odstępach); npos, jeśli pola nie ma
+size_t findValue(const std::string& json, const std::string& key) {
+    std::string quoted = "\"" + escapeJson(key) + "\"";
+    size_t position = 0;
+    while ((position = json.find(quoted, position)) != std::string::npos) {
+        position += quoted.size();
+        size_t colon = json.find_first_not_of(" \t", position);
+        if (colon != std::string::npos && json[colon] == ':') {
+            return json.find_first_not_of(" \t", colon + 1);
+        }
+    }
+    return std::string::npos;
+}
+
+}
+
+std::string jsonStringField(const std::string& json, const std::string& key) {
+    size_t position = findValue(json, key);
+    if (position == std::string::npos || json[position] != '"') {
+        return "";
+    }
+    
+    std::string value;
+    for (size_t i = position + 1; i < json.size(); ++i) {
+        char c = json[i];
+        if (c == '"') {
+            return value;
+        }
+        if (c != '\\' || i + 1 >= json.size()) {
+            value += c;
+            continue;
+        }
+        char escaped = json[++i];
+        switch (escaped) {
+            case 'n': value += '\n'; break;
+            case 't': value += '\t'; break;
+            case 'r': value += '\r'; break;
+            case 'u':
+                // Znaki sterujące z escapeJson (\u00XX); pozostałe kody poza ASCII nie występują
+                if (i + 4 < json.size()) {
+                    value += static_cast<char>(std::strtol(json.substr(i + 1, 4).c_str(), nullptr, 16));
+                    i += 4;
+                }
+                break;
+            default: value += escaped;
+        }
+    }
+    return "";
+}
+
+bool jsonNumberField(const std::string& json, const std::string& key, double& value) {
+    size_t position = findValue(json, key);
+    if (position == std::string::npos) {
+        return false;
+    }
+    char* end = nullptr;
+    value = std::strtod(json.c_str() + position, &end);
+    return end != json.c_str() + position;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+
+// Zapis napisu jako zawartości literału JSON (bez otaczających cudzysłowów)
+std::string escapeJson(const std::string& text);
+
+// Wartość pola tekstowego z płaskiego obiektu JSON (np. {"command":"cancel"});
+// pusta, jeśli pola nie ma lub nie jest napisem
+std::string jsonStringField(const std::string& json, const std::string& key);
+
+// Wartość pola liczbowego z płaskiego obiektu JSON; false, jeśli pola nie ma
+bool jsonNumberField(const std::string& json, const std::string& key, double& value);
@@ -0,0 +1,83 @@
+#include "kernel-modules.h"
+#include "file-utils.h"
+
+#include <sstream>
+#include <utility>
+
+KernelModuleTable KernelModuleTable::load(const std::string& procRoot) {
+    KernelModuleTable table;
+    table.parse(readFileContents(procRoot + "/modules"));
+    return table;
+}
+
+void KernelModuleTable::parse(const std::string& text) {
+    contents = text;
+    modules.clear();
+    
+    // Format linii: nazwa rozmiar odwołania zależne,|- stan adres
+    std::istringstream stream(text);
+    std::string line;
+    while (std::getline(stream, line)) {
+        std::istringstream fields(line);
+        KernelModule module;
+        std::string usedBy;
+        
+        if (!(fields >> module.name >> module.size >> module.refCount >> usedBy)) {
+            continue;
+        }
+        fields >> module.state;
+        
+        if (usedBy != "-") {
+            std::istringstream names(usedBy);
+            std::string name;
+            while (std::getline(names, name, ',')) {
+                if (!name.empty()) {
+                    module.usedBy.push_back(name);
+                }
+            }
+        }
+        
+        modules[module.name] = std::move(module);
+    }
+}
+
+bool KernelModuleTable::isLoaded(const std::string& name) const {
+    return modules.count(name) != 0;
+}
+
+const KernelModule* KernelModuleTable::find(const std::string& name) const {
+    auto it = modules.find(name);
+    return it == modules.end() ? nullptr : &it->second;
+}
+
+std::vector<std::string> KernelModuleTable::names() const {
+    std::vector<std::string> result;
+    for (const auto& module : modules) {
+        result.push_back(module.first);
+    }
+    return result;
+}
+
+DriverResolver::DriverResolver(std::string sysfsRoot, std::shared_ptr<const KernelModuleTable> modules)
+    : sysfsRoot(std::move(sysfsRoot)), modules(std::move(modules)) {
+}
+
+std::string DriverResolver::boundDriver(const std::string& slot) const {
+    return readLinkBasename(sysfsRoot + "/bus/pci/devices/" + slot + "/driver");
+}
+
+std::string DriverResolver::resolve(const std::string& slot, const std::vector<std::string>& candidates) const {
+    std::string driver = boundDriver(slot);
+    if (!driver.empty()) {
+        return driver;
+    }
+    
+    // Moduł może być załadowany, ale nie przejął urządzenia (np. nvidia przy aktywnym nouveau)
+    for (const auto& candidate : candidates) {
+        if (modules->isLoaded(candidate)) {
+            return candidate + " (niezwiązany)";
+        }
+    }
+    
+    return "none";
+}
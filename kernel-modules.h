@@ -0,0 +1,65 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Moduł jądra odczytany z /proc/modules
+struct KernelModule {
+    std::string name;                 // Nazwa modułu (np. nouveau)
+    unsigned long size = 0;           // Rozmiar w bajtach
+    int refCount = 0;                 // Liczba odwołań
+    std::vector<std::string> usedBy;  // Moduły zależne
+    std::string state;                // Live, Loading lub Unloading
+};
+
+// Migawka /proc/modules wczytana jednorazowo i współdzielona przez wszystkie zapytania
+class KernelModuleTable {
+private:
+    std::map<std::string, KernelModule> modules;
+    std::string contents;
+
+public:
+    // Wczytanie tabeli z <procRoot>/modules
+    static KernelModuleTable load(const std::string& procRoot = "/proc");
+    
+    // Parsowanie zawartości w formacie /proc/modules
+    void parse(const std::string& text);
+    
+    bool isLoaded(const std::string& name) const;
+    const KernelModule* find(const std::string& name) const;
+    
+    // Surowa zawartość migawki (np. do kopii zapasowej)
+    const std::string& snapshot() const {
+        return contents;
+    }
+    
+    size_t size() const {
+        return modules.size();
+    }
+    
+    // Nazwy załadowanych modułów w kolejności alfabetycznej
+    std::vector<std::string> names() const;
+};
+
+// Ustalanie sterownika związanego z konkretnym urządzeniem PCI
+class DriverResolver {
+private:
+    std::string sysfsRoot;
+    std::shared_ptr<const KernelModuleTable> modules;
+
+public:
+    DriverResolver(std::string sysfsRoot, std::shared_ptr<const KernelModuleTable> modules);
+    
+    // Sterownik z dowiązania /sys/bus/pci/devices/<BDF>/driver (pusty, jeśli brak)
+    std::string boundDriver(const std::string& slot) const;
+    
+    // Sterownik urządzenia: związany sterownik, a w przeciwnym razie pierwszy załadowany
+    // moduł z listy kandydatów oznaczony jako niezwiązany lub "none"
+    std::string resolve(const std::string& slot, const std::vector<std::string>& candidates = {}) const;
+    
+    const KernelModuleTable& moduleTable() const {
+        return *modules;
+    }
+};
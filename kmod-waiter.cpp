@@ -0,0 +1,180 @@
+#include "kmod-waiter.h"
+#include "file-utils.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <utility>
+
+// Dla inotify, poll i uname
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#include <dirent.h>
+
+namespace fs = std::filesystem;
+
+KmodWaiter::KmodWaiter(KmodWaitOptions options) : options(std::move(options)) {
+    if (this->options.kernelRelease.empty()) {
+        this->options.kernelRelease = runningKernelRelease();
+    }
+    extraDir = this->options.modulesRoot + "/" + this->options.kernelRelease + "/extra";
+}
+
+KmodWaitResult KmodWaiter::wait() {
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + options.timeout;
+    // akmods startuje już w posttrans transakcji dnf, więc jego log może być starszy niż oczekiwanie
+    const std::time_t started = options.buildStarted ? options.buildStarted : std::time(nullptr);
+    
+    // Obserwowane są katalog jądra (gdy extra jeszcze nie istnieje), extra i jego podkatalogi
+    int inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    auto addWatches = [&]() {
+        if (inotifyFd < 0) {
+            return;
+        }
+        const uint32_t mask = IN_CREATE | IN_MOVED_TO | IN_CLOSE_WRITE;
+        inotify_add_watch(inotifyFd, (options.modulesRoot + "/" + options.kernelRelease).c_str(), mask);
+        std::error_code error;
+        if (!fs::is_directory(extraDir, error)) {
+            return;
+        }
+        inotify_add_watch(inotifyFd, extraDir.c_str(), mask);
+        for (fs::recursive_directory_iterator it(extraDir, error), end; !error && it != end; it.increment(error)) {
+            if (it->is_directory(error)) {
+                inotify_add_watch(inotifyFd, it->path().c_str(), mask);
+            }
+        }
+    };
+    addWatches();
+    
+    auto interval = options.initialPoll;
+    bool akmodsSeen = false;
+    KmodWaitResult result = KmodWaitResult::TIMEOUT;
+    
+    while (true) {
+        bool running = akmodsRunning();
+        akmodsSeen = akmodsSeen || running;
+        
+        // Moduł jest gotowy, gdy plik istnieje, a akmods skończył instalację pakietu kmod
+        if (moduleBuilt() && !running) {
+            result = KmodWaitResult::READY;
+            break;
+        }
+        
+        if (buildFailureLogged(started) || (akmodsSeen && !running && !moduleBuilt())) {
+            result = KmodWaitResult::BUILD_FAILED;
+            break;
+        }
+        
+        auto now = Clock::now();
+        if (now >= deadline) {
+            break;
+        }
+        
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+        auto sleep = std::min(interval, remaining);
+        
+        pollfd descriptors[2];
+        nfds_t count = 0;
+        if (inotifyFd >= 0) {
+            descriptors[count++] = {inotifyFd, POLLIN, 0};
+        }
+        if (options.cancelFd >= 0) {
+            descriptors[count++] = {options.cancelFd, POLLIN, 0};
+        }
+        
+        bool woken = false;
+        if (count == 0) {
+            usleep(static_cast<useconds_t>(sleep.count()) * 1000);
+        } else if (poll(descriptors, count, static_cast<int>(sleep.count())) > 0) {
+            if (options.cancelFd >= 0 && (descriptors[count - 1].revents & POLLIN)) {
+                result = KmodWaitResult::CANCELLED;
+                break;
+            }
+            if (inotifyFd >= 0 && (descriptors[0].revents & POLLIN)) {
+                char buffer[4096];
+                while (read(inotifyFd, buffer, sizeof(buffer)) > 0) {
+                }
+                woken = true;
+                // Nowe podkatalogi (np. extra/nvidia) też muszą być obserwowane
+                addWatches();
+            }
+        }
+        
+        // Bez zdarzeń interwał rośnie wykładniczo; zdarzenie oznacza postęp, więc wraca do minimum
+        interval = woken ? options.initialPoll : std::min(interval * 2, options.maxPoll);
+    }
+    
+    if (inotifyFd >= 0) {
+        close(inotifyFd);
+    }
+    return result;
+}
+
+bool KmodWaiter::moduleBuilt() const {
+    const std::string prefix = options.moduleName + ".ko";
+    std::error_code error;
+    
+    for (fs::recursive_directory_iterator it(extraDir, error), end; !error && it != end; it.increment(error)) {
+        std::string name = it->path().filename().string();
+        if (name == prefix || name == prefix + ".xz" || name == prefix + ".zst" || name == prefix + ".gz") {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool KmodWaiter::akmodsRunning() const {
+    DIR* dir = opendir(options.procRoot.c_str());
+    if (!dir) {
+        return false;
+    }
+    
+    bool running = false;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9') {
+            continue;
+        }
+        std::string comm = readFirstLine(options.procRoot + "/" + entry->d_name + "/comm");
+        if (comm == "akmods" || comm == "akmodsbuild") {
+            running = true;
+            break;
+        }
+    }
+    closedir(dir);
+    return running;
+}
+
+bool KmodWaiter::buildFailureLogged(std::time_t since) const {
+    // akmods zapisuje <katalog>/<kmod>/<wersja>-for-<jądro>.failed.log; gałęzie starszych
+    // sterowników mają własny katalog kmod (np. nvidia-470xx) z tym samym modułem nvidia
+    const std::string suffix = "-for-" + options.kernelRelease + ".failed.log";
+    const std::string branchPrefix = options.moduleName + "-";
+    std::error_code error;
+    
+    for (fs::recursive_directory_iterator it(options.akmodsCacheDir, error), end; !error && it != end; it.increment(error)) {
+        std::string name = it->path().filename().string();
+        std::string kmod = it->path().parent_path().filename().string();
+        if (name.size() <= suffix.size() || name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0 ||
+            (kmod != options.moduleName && kmod.compare(0, branchPrefix.size(), branchPrefix) != 0)) {
+            continue;
+        }
+        
+        // Logi z wcześniejszych prób nie dotyczą bieżącej kompilacji
+        struct stat info;
+        if (stat(it->path().c_str(), &info) == 0 && info.st_mtime >= since) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string KmodWaiter::runningKernelRelease() {
+    utsname info;
+    if (uname(&info) != 0) {
+        return "";
+    }
+    return info.release;
+}
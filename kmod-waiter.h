@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <ctime>
+#include <string>
+
+// Ustawienia oczekiwania na zbudowanie modułu jądra przez akmods
+struct KmodWaitOptions {
+    std::string moduleName = "nvidia";              // Nazwa modułu (plik <nazwa>.ko[.xz|.zst])
+    std::string modulesRoot = "/lib/modules";       // Katalog modułów jądra
+    std::string kernelRelease;                      // Wersja jądra (pusta: uname -r)
+    std::string procRoot = "/proc";                 // Do śledzenia procesów akmods
+    std::string akmodsCacheDir = "/var/cache/akmods"; // Logi nieudanych kompilacji
+    std::time_t buildStarted = 0;                   // Początek transakcji uruchamiającej akmods (0: początek oczekiwania)
+    std::chrono::seconds timeout{900};              // Całkowity limit czasu
+    std::chrono::milliseconds initialPoll{250};     // Pierwszy interwał odpytywania
+    std::chrono::milliseconds maxPoll{8000};        // Najdłuższy interwał odpytywania
+    int cancelFd = -1;                              // Gotowość do odczytu przerywa oczekiwanie
+};
+
+// Wynik oczekiwania na moduł
+enum class KmodWaitResult {
+    READY,         // Moduł jest zbudowany i zainstalowany
+    BUILD_FAILED,  // akmods zakończył pracę bez modułu lub zostawił log błędu
+    TIMEOUT,       // Przekroczono limit czasu
+    CANCELLED      // Oczekiwanie przerwano na żądanie
+};
+
+// Oczekiwanie na moduł w /lib/modules/<wersja>/extra: inotify z odpytywaniem
+// o wykładniczo rosnącym interwale jako zabezpieczeniem
+class KmodWaiter {
+private:
+    KmodWaitOptions options;
+    std::string extraDir;
+
+public:
+    explicit KmodWaiter(KmodWaitOptions options);
+    
+    KmodWaitResult wait();
+    
+    // Czy plik modułu istnieje w katalogu extra
+    bool moduleBuilt() const;
+    
+    // Czy działa proces akmods/akmodsbuild
+    bool akmodsRunning() const;
+    
+    // Czy akmods zostawił log nieudanej kompilacji modułu dla jądra po podanej chwili
+    bool buildFailureLogged(std::time_t since) const;
+    
+    // Wersja działającego jądra (uname -r)
+    static std::string runningKernelRelease();
+    
+    const std::string& moduleDirectory() const {
+        return extraDir;
+    }
+};
@@ -0,0 +1,266 @@
+#include "logger.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <utility>
+
+// Dla operacji na plikach i gniazdach
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// Zapis całego bufora (write może zapisać mniej bajtów niż żądano)
+void writeAll(int fd, const std::string& data) {
+    size_t offset = 0;
+    while (offset < data.size()) {
+        ssize_t count = write(fd, data.data() + offset, data.size() - offset);
+        if (count <= 0) {
+            return;
+        }
+        offset += static_cast<size_t>(count);
+    }
+}
+
+// Priorytety syslog używane przez journald
+int journalPriority(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG:   return 7;
+        case LogLevel::INFO:    return 6;
+        case LogLevel::WARNING: return 4;
+        case LogLevel::ERROR:   return 3;
+    }
+    return 6;
+}
+
+// Pole w formacie natywnym journald; wartości wielowierszowe w postaci binarnej
+void appendJournalField(std::string& datagram, const std::string& name, const std::string& value) {
+    if (value.find('\n') == std::string::npos) {
+        datagram += name + "=" + value + "\n";
+        return;
+    }
+    
+    datagram += name + "\n";
+    uint64_t length = value.size();
+    for (int i = 0; i < 8; ++i) {
+        datagram += static_cast<char>((length >> (8 * i)) & 0xff);
+    }
+    datagram += value + "\n";
+}
+
+}
+
+Logger::Logger(LoggerOptions options) : options(std::move(options)) {
+    ring.resize(this->options.capacity == 0 ? 1 : this->options.capacity);
+    
+    if (!this->options.path.empty()) {
+        openFile();
+    }
+    
+    if (this->options.journal) {
+        journalFd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (journalFd >= 0) {
+            sockaddr_un address = {};
+            address.sun_family = AF_UNIX;
+            std::strncpy(address.sun_path, "/run/systemd/journal/socket", sizeof(address.sun_path) - 1);
+            if (connect(journalFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                close(journalFd);
+                journalFd = -1;
+            }
+        }
+    }
+    
+    writer = std::thread(&Logger::run, this);
+}
+
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    notEmpty.notify_all();
+    writer.join();
+    
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (journalFd >= 0) {
+        close(journalFd);
+    }
+}
+
+void Logger::log(LogLevel level, const std::string& message) {
+    Entry entry = {std::chrono::system_clock::now(), level, message};
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    // Pełny bufor spowalnia producenta zamiast gubić komunikaty
+    notFull.wait(lock, [this]() {
+        return count < ring.size() || stopping;
+    });
+    if (stopping) {
+        return;
+    }
+    
+    ring[(head + count) % ring.size()] = std::move(entry);
+    ++count;
+    ++accepted;
+    lock.unlock();
+    notEmpty.notify_one();
+}
+
+void Logger::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    size_t target = accepted;
+    drained.wait(lock, [this, target]() {
+        return written >= target || stopping;
+    });
+}
+
+void Logger::run() {
+    std::vector<Entry> batch;
+    batch.reserve(ring.size());
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        notEmpty.wait(lock, [this]() {
+            return count > 0 || stopping;
+        });
+        if (count == 0 && stopping) {
+            break;
+        }
+        
+        // Przeniesienie całej zawartości bufora i zapis poza blokadą
+        while (count > 0) {
+            batch.push_back(std::move(ring[head]));
+            head = (head + 1) % ring.size();
+            --count;
+        }
+        lock.unlock();
+        notFull.notify_all();
+        
+        writeBatch(batch);
+        size_t batchSize = batch.size();
+        batch.clear();
+        
+        lock.lock();
+        written += batchSize;
+        drained.notify_all();
+    }
+    drained.notify_all();
+}
+
+void Logger::writeBatch(const std::vector<Entry>& batch) {
+    std::string fileText;
+    std::string consoleText;
+    
+    for (const auto& entry : batch) {
+        fileText += formatTimestamp(entry.time) + " " + levelName(entry.level) + " " + entry.message + "\n";
+        if (options.console) {
+            consoleText += entry.message + "\n";
+        }
+        if (journalFd >= 0) {
+            sendToJournal(entry);
+        }
+    }
+    
+    if (!consoleText.empty()) {
+        std::fwrite(consoleText.data(), 1, consoleText.size(), stdout);
+        std::fflush(stdout);
+    }
+    
+    if (fd >= 0) {
+        if (fileSize + fileText.size() > options.maxFileSize && fileSize > 0) {
+            rotate();
+        }
+        if (fd >= 0) {
+            writeAll(fd, fileText);
+            fileSize += fileText.size();
+        }
+    }
+}
+
+void Logger::openFile() {
+    fd = open(options.path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    fileSize = 0;
+    
+    struct stat info;
+    if (fd >= 0 && fstat(fd, &info) == 0) {
+        fileSize = static_cast<size_t>(info.st_size);
+    }
+}
+
+void Logger::rotate() {
+    close(fd);
+    fd = -1;
+    
+    // install.log.(N-1) -> install.log.N, ..., install.log -> install.log.1
+    for (int i = options.maxFiles - 1; i >= 1; --i) {
+        std::string from = options.path + "." + std::to_string(i);
+        std::string to = options.path + "." + std::to_string(i + 1);
+        std::rename(from.c_str(), to.c_str());
+    }
+    if (options.maxFiles > 0) {
+        std::rename(options.path.c_str(), (options.path + ".1").c_str());
+    } else {
+        unlink(options.path.c_str());
+    }
+    
+    openFile();
+}
+
+void Logger::sendToJournal(const Entry& entry) {
+    std::string datagram;
+    appendJournalField(datagram, "MESSAGE", entry.message);
+    appendJournalField(datagram, "PRIORITY", std::to_string(journalPriority(entry.level)));
+    appendJournalField(datagram, "SYSLOG_IDENTIFIER", options.identifier);
+    send(journalFd, datagram.data(), datagram.size(), MSG_NOSIGNAL);
+}
+
+std::string Logger::formatTimestamp(std::chrono::system_clock::time_point time) {
+    std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() % 1000;
+    
+    std::tm local;
+    localtime_r(&seconds, &local);
+    
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &local);
+    char zone[8];
+    std::strftime(zone, sizeof(zone), "%z", &local);
+    
+    // %z daje +0200, ISO-8601 w postaci rozszerzonej wymaga +02:00
+    char result[64];
+    std::snprintf(result, sizeof(result), "%s.%03d%.3s:%.2s", date, static_cast<int>(millis), zone, zone + 3);
+    return result;
+}
+
+const char* Logger::levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG:   return "DEBUG";
+        case LogLevel::INFO:    return "INFO";
+        case LogLevel::WARNING: return "WARNING";
+        case LogLevel::ERROR:   return "ERROR";
+    }
+    return "INFO";
+}
+
+bool Logger::stderrIsJournal() {
+    // Format zmiennej: "<st_dev>:<st_ino>" strumienia podłączonego przez systemd
+    const char* stream = std::getenv("JOURNAL_STREAM");
+    unsigned long long device, inode;
+    if (!stream || std::sscanf(stream, "%llu:%llu", &device, &inode) != 2) {
+        return false;
+    }
+    struct stat status;
+    if (fstat(STDERR_FILENO, &status) != 0) {
+        return false;
+    }
+    return static_cast<unsigned long long>(status.st_dev) == device &&
+           static_cast<unsigned long long>(status.st_ino) == inode;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Poziom ważności komunikatu
+enum class LogLevel {
+    DEBUG,
+    INFO,
+    WARNING,
+    ERROR
+};
+
+// Ustawienia dziennika
+struct LoggerOptions {
+    std::string path;                            // Plik dziennika (pusty: bez zapisu do pliku)
+    size_t maxFileSize = 4 * 1024 * 1024;        // Rozmiar, po którym plik jest rotowany
+    int maxFiles = 5;                            // Liczba zachowywanych plików (.1 ... .N)
+    size_t capacity = 4096;                      // Pojemność bufora cyklicznego (komunikaty)
+    bool console = true;                         // Wypisywanie komunikatów na standardowe wyjście
+    bool journal = false;                        // Wysyłanie do journald (protokół natywny)
+    std::string identifier = "auto-driver-installer"; // SYSLOG_IDENTIFIER w journald
+};
+
+// Asynchroniczny dziennik: komunikaty z dowolnego wątku trafiają do bufora
+// cyklicznego, a jeden wątek zapisujący opróżnia go paczkami do stale otwartego pliku
+class Logger {
+private:
+    struct Entry {
+        std::chrono::system_clock::time_point time;
+        LogLevel level;
+        std::string message;
+    };
+    
+    LoggerOptions options;
+    std::vector<Entry> ring;
+    size_t head = 0;       // Indeks najstarszego komunikatu
+    size_t count = 0;      // Liczba komunikatów w buforze
+    size_t written = 0;    // Liczba komunikatów zapisanych przez wątek zapisujący
+    size_t accepted = 0;   // Liczba komunikatów przyjętych do bufora
+    bool stopping = false;
+    
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::condition_variable drained;
+    std::thread writer;
+    
+    int fd = -1;
+    size_t fileSize = 0;
+    int journalFd = -1;
+
+public:
+    explicit Logger(LoggerOptions options);
+    ~Logger();
+    
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+    
+    void log(LogLevel level, const std::string& message);
+    
+    // Oczekiwanie, aż wszystkie dotychczasowe komunikaty zostaną zapisane
+    void flush();
+    
+    // Znacznik czasu ISO-8601 z milisekundami i strefą czasową
+    static std::string formatTimestamp(std::chrono::system_clock::time_point time);
+    static const char* levelName(LogLevel level);
+    
+    // Czy standardowe wyjście błędów jest strumieniem journald (JOURNAL_STREAM wskazuje
+    // ten sam plik). Sama zmienna nie wystarcza: dziedziczą ją np. terminale z usług użytkownika.
+    static bool stderrIsJournal();
+
+private:
+    void run();
+    void writeBatch(const std::vector<Entry>& batch);
+    void openFile();
+    void rotate();
+    void sendToJournal(const Entry& entry);
+};
@@ -0,0 +1,171 @@
+#include "package-backend.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+DnfBackend::DnfBackend(std::shared_ptr<CommandRunner> runner, CommandRunner::OutputCallback onOutput,
+                       PackageStateOptions stateOptions)
+    : runner(std::move(runner)), onOutput(std::move(onOutput)), state(std::move(stateOptions)) {
+}
+
+bool DnfBackend::install(const std::vector<std::string>& packages) {
+    return transaction("install", packages);
+}
+
+bool DnfBackend::remove(const std::vector<std::string>& packages) {
+    return transaction("remove", packages);
+}
+
+bool DnfBackend::reinstall(const std::vector<std::string>& packages) {
+    return transaction("reinstall", packages);
+}
+
+bool DnfBackend::isRepositoryEnabled(const std::string& repositoryId) {
+    // Pliki .repo zamiast dnf repolist, które pobiera lub odświeża metadane wszystkich repozytoriów
+    return state.isRepositoryEnabled(repositoryId);
+}
+
+std::string DnfBackend::releaseVersion() {
+    std::string version = state.releaseVersion();
+    if (!version.empty()) {
+        return version;
+    }
+    
+    CommandResult result = runner->run({"rpm", "-E", "%fedora"});
+    version = result.output.substr(0, result.output.find('\n'));
+    return result.success() ? version : "";
+}
+
+std::string DnfBackend::lastTransactionId() {
+    // Pierwsza kolumna wierszy z danymi to numer transakcji; nagłówki bywają
+    // przetłumaczone, a kolejność wierszy różni się między dnf4 i dnf5, więc liczy się maksimum
+    CommandResult result = runner->run({"dnf", "history", "list"});
+    if (!result.success()) {
+        return "";
+    }
+    
+    unsigned long last = 0;
+    std::istringstream stream(result.output);
+    std::string line;
+    while (std::getline(stream, line)) {
+        std::istringstream fields(line);
+        std::string first;
+        fields >> first;
+        if (!first.empty() && first.find_first_not_of("0123456789") == std::string::npos) {
+            last = std::max(last, std::stoul(first));
+        }
+    }
+    return last == 0 ? "" : std::to_string(last);
+}
+
+bool DnfBackend::undoTransaction(const std::string& id) {
+    return runner->run(dnfCommand({"history", "undo", "-y", id}), onOutput).success();
+}
+
+bool DnfBackend::rollbackTransactions(const std::string& firstId) {
+    // rollback N wycofuje wszystko po transakcji N, czyli od firstId włącznie
+    unsigned long first = std::stoul(firstId);
+    if (first <= 1) {
+        return undoTransaction(firstId);
+    }
+    return runner->run(dnfCommand({"history", "rollback", "-y", std::to_string(first - 1)}), onOutput).success();
+}
+
+std::map<std::string, std::string> DnfBackend::installedVersions(const std::vector<std::string>& packages) {
+    std::map<std::string, std::string> versions;
+    if (packages.empty() || state.installedVersions(packages, versions)) {
+        return versions;
+    }
+    
+    // Bez librpm jedno zapytanie rpm dla wszystkich pakietów; kod wyjścia jest niezerowy,
+    // gdy któregoś brakuje, więc liczą się tylko wiersze w formacie zapytania
+    std::vector<std::string> argv = {"rpm", "-q", "--qf", "%{NAME}\t%{EPOCHNUM}:%{VERSION}-%{RELEASE}.%{ARCH}\n"};
+    argv.insert(argv.end(), packages.begin(), packages.end());
+    CommandResult result = runner->run(argv);
+    
+    std::istringstream stream(result.output);
+    std::string line;
+    while (std::getline(stream, line)) {
+        size_t tab = line.find('\t');
+        if (tab == std::string::npos) {
+            continue;
+        }
+        std::string name = line.substr(0, tab);
+        if (std::find(packages.begin(), packages.end(), name) != packages.end()) {
+            versions[name] = line.substr(tab + 1);
+        }
+    }
+    return versions;
+}
+
+bool DnfBackend::transaction(const std::string& verb, const std::vector<std::string>& packages) {
+    if (packages.empty()) {
+        return true;
+    }
+    
+    std::vector<std::string> argv = dnfCommand({verb, "-y"});
+    argv.insert(argv.end(), packages.begin(), packages.end());
+    return runner->run(argv, onOutput).success();
+}
+
+bool DnfBackend::download(const std::vector<std::string>& packages, const std::string& directory,
+                          bool allDependencies, const CommandRunner::OutputCallback& onOutput) {
+    if (packages.empty()) {
+        return true;
+    }
+    
+    std::error_code error;
+    fs::create_directories(directory, error);
+    
+    // Pobieranie działa w tle (np. w czasie pytania o zgodę), więc wyjście nie trafia na ekran,
+    // a bez wywołania zwrotnego dnf nie wypisuje nawet linii zakończonych pobrań
+    std::vector<std::string> argv = {"dnf", "download"};
+    if (!onOutput) {
+        argv.push_back("-q");
+    }
+    argv.push_back("--resolve");
+    
+    // Samo --resolve pomija zależności zainstalowane na tej maszynie, a na innej bez sieci ich zabraknie
+    if (allDependencies) {
+        argv.push_back("--alldeps");
+    }
+    argv.insert(argv.end(), {"--destdir", directory});
+    argv.insert(argv.end(), packages.begin(), packages.end());
+    return runner->run(argv, onOutput).success();
+}
+
+bool DnfBackend::createRepository(const std::string& directory) {
+    // --update przelicza tylko pakiety dodane od poprzedniego uruchomienia
+    return runner->run({"createrepo_c", "--quiet", "--update", directory}).success();
+}
+
+void DnfBackend::useLocalRepository(const std::string& directory, bool exclusive) {
+    localRepository = directory;
+    localOnly = exclusive;
+}
+
+std::vector<std::string> DnfBackend::dnfCommand(const std::vector<std::string>& arguments) const {
+    std::vector<std::string> argv = {"dnf"};
+    if (!localRepository.empty()) {
+        std::string id = localRepositoryId;
+        argv.push_back("--repofrompath=" + id + "," + fs::absolute(localRepository).string());
+        
+        // Niższy koszt: ta sama wersja pakietu jest brana z dysku, a nowsza nadal z sieci
+        argv.push_back("--setopt=" + id + ".cost=100");
+        
+        // Podpisy sprawdzane kluczami Fedory i RPM Fusion (te instalują pakiety *-release)
+        argv.push_back("--setopt=" + id + ".gpgkey="
+                       "file:///etc/pki/rpm-gpg/RPM-GPG-KEY-fedora-$releasever-$basearch "
+                       "file:///etc/pki/rpm-gpg/RPM-GPG-KEY-rpmfusion-free-fedora-$releasever "
+                       "file:///etc/pki/rpm-gpg/RPM-GPG-KEY-rpmfusion-nonfree-fedora-$releasever");
+        if (localOnly) {
+            argv.push_back("--repo=" + id);
+        }
+    }
+    argv.insert(argv.end(), arguments.begin(), arguments.end());
+    return argv;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "command-runner.h"
+#include "package-state.h"
+
+// Operacje na pakietach wykonywane przez instalator
+class PackageBackend {
+public:
+    virtual ~PackageBackend() = default;
+    
+    // Instalacja pakietów (nazwy lub adresy URL plików RPM) w jednej transakcji
+    virtual bool install(const std::vector<std::string>& packages) = 0;
+    
+    // Usunięcie pakietów (dopuszczalne wzorce, np. xorg-x11-drv-nvidia*)
+    virtual bool remove(const std::vector<std::string>& packages) = 0;
+    
+    // Ponowna instalacja pakietów z repozytorium
+    virtual bool reinstall(const std::vector<std::string>& packages) = 0;
+    
+    // Czy włączone jest repozytorium, którego identyfikator zawiera podany ciąg
+    virtual bool isRepositoryEnabled(const std::string& repositoryId) = 0;
+    
+    // Numer wydania systemu (odpowiednik rpm -E %fedora)
+    virtual std::string releaseVersion() = 0;
+    
+    // Identyfikator ostatniej transakcji w historii (pusty, jeśli nieznany)
+    virtual std::string lastTransactionId() = 0;
+    
+    // Wycofanie jednej transakcji (dnf history undo)
+    virtual bool undoTransaction(const std::string& id) = 0;
+    
+    // Wycofanie transakcji firstId i wszystkich późniejszych w jednej transakcji (dnf history rollback)
+    virtual bool rollbackTransactions(const std::string& firstId) = 0;
+    
+    // Wersje zainstalowanych pakietów spośród podanych (brakujących nie ma w wyniku)
+    virtual std::map<std::string, std::string> installedVersions(const std::vector<std::string>& packages) = 0;
+    
+    // Pobranie pakietów i ich brakujących zależności do katalogu, bez instalacji; z allDependencies
+    // także zależności już zainstalowanych (repozytorium dla innych maszyn). onOutput otrzymuje
+    // wyjście pobierania (np. do śledzenia postępu).
+    virtual bool download(const std::vector<std::string>& packages, const std::string& directory,
+                          bool allDependencies = false, const CommandRunner::OutputCallback& onOutput = nullptr) = 0;
+    
+    // Utworzenie lub odświeżenie metadanych repozytorium w katalogu z pakietami
+    virtual bool createRepository(const std::string& directory) = 0;
+    
+    // Lokalne repozytorium (katalog z metadanymi) dla kolejnych transakcji: pakiety w nim
+    // obecne nie są pobierane ponownie; exclusive: jedyne źródło pakietów (bez sieci)
+    virtual void useLocalRepository(const std::string& directory, bool exclusive) = 0;
+};
+
+// Operacje na pakietach przez dnf; zapytania tylko do odczytu (repozytoria, wydanie,
+// zainstalowane pakiety) są wykonywane w procesie, bez uruchamiania dnf
+class DnfBackend : public PackageBackend {
+private:
+    std::shared_ptr<CommandRunner> runner;
+    CommandRunner::OutputCallback onOutput;
+    PackageState state;
+    std::string localRepository;  // Katalog lokalnego repozytorium (pusty: brak)
+    bool localOnly = false;       // Transakcje tylko z lokalnego repozytorium
+
+public:
+    // onOutput otrzymuje wyjście transakcji dnf (np. do wyświetlenia postępu)
+    explicit DnfBackend(std::shared_ptr<CommandRunner> runner, CommandRunner::OutputCallback onOutput = nullptr,
+                        PackageStateOptions stateOptions = PackageStateOptions());
+    
+    bool install(const std::vector<std::string>& packages) override;
+    bool remove(const std::vector<std::string>& packages) override;
+    bool reinstall(const std::vector<std::string>& packages) override;
+    bool isRepositoryEnabled(const std::string& repositoryId) override;
+    std::string releaseVersion() override;
+    std::string lastTransactionId() override;
+    bool undoTransaction(const std::string& id) override;
+    bool rollbackTransactions(const std::string& firstId) override;
+    std::map<std::string, std::string> installedVersions(const std::vector<std::string>& packages) override;
+    bool download(const std::vector<std::string>& packages, const std::string& directory,
+                  bool allDependencies = false, const CommandRunner::OutputCallback& onOutput = nullptr) override;
+    bool createRepository(const std::string& directory) override;
+    void useLocalRepository(const std::string& directory, bool exclusive) override;
+    
+    // Identyfikator lokalnego repozytorium w opcjach dnf
+    static constexpr const char* localRepositoryId = "auto-driver-installer-cache";
+
+private:
+    bool transaction(const std::string& verb, const std::vector<std::string>& packages);
+    
+    // Polecenie dnf zmieniające system z opcjami lokalnego repozytorium
+    std::vector<std::string> dnfCommand(const std::vector<std::string>& arguments) const;
+};
@@ -0,0 +1,190 @@
+#include "package-state.h"
+#include "file-utils.h"
+
+#include <algorithm>
+#include <cctype>
+#include <dirent.h>
+#include <set>
+#include <sstream>
+#include <utility>
+
+#ifdef HAVE_LIBRPM
+#include <cstdlib>
+#include <mutex>
+#include <rpm/header.h>
+#include <rpm/rpmdb.h>
+#include <rpm/rpmlib.h>
+#include <rpm/rpmts.h>
+#endif
+
+namespace {
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+// Wartości logiczne w plikach .repo jak w libdnf: 1/0, yes/no, true/false, on/off
+bool parseBoolean(std::string value, bool fallback) {
+    std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (value == "1" || value == "yes" || value == "true" || value == "on") {
+        return true;
+    }
+    if (value == "0" || value == "no" || value == "false" || value == "off") {
+        return false;
+    }
+    return fallback;
+}
+
+// Nazwy plików *.repo w katalogu, posortowane
+std::vector<std::string> listRepositoryFiles(const std::string& dir) {
+    std::vector<std::string> files;
+    DIR* handle = opendir(dir.c_str());
+    if (!handle) {
+        return files;
+    }
+    while (dirent* entry = readdir(handle)) {
+        std::string name = entry->d_name;
+        if (name[0] != '.' && name.size() > 5 && name.compare(name.size() - 5, 5, ".repo") == 0) {
+            files.push_back(name);
+        }
+    }
+    closedir(handle);
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+}
+
+PackageState::PackageState(PackageStateOptions options) : options(std::move(options)) {
+}
+
+std::vector<RepositoryConfig> PackageState::parseRepositoryFile(const std::string& text, const std::string& file) {
+    std::vector<RepositoryConfig> repositories;
+    std::istringstream stream(text);
+    std::string line;
+    while (std::getline(stream, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#' || line[0] == ';') {
+            continue;
+        }
+        if (line.front() == '[' && line.back() == ']') {
+            RepositoryConfig repository;
+            repository.id = trim(line.substr(1, line.size() - 2));
+            repository.file = file;
+            // Sekcja [main] to ustawienia ogólne, a nie repozytorium
+            if (repository.id != "main") {
+                repositories.push_back(repository);
+            }
+            continue;
+        }
+        
+        size_t equals = line.find('=');
+        if (repositories.empty() || equals == std::string::npos) {
+            continue;
+        }
+        std::string key = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+        if (key == "enabled") {
+            repositories.back().enabled = parseBoolean(value, true);
+        } else if (key == "name") {
+            repositories.back().name = value;
+        }
+    }
+    return repositories;
+}
+
+std::vector<RepositoryConfig> PackageState::repositories() const {
+    std::vector<RepositoryConfig> result;
+    std::set<std::string> seenFiles;
+    for (const auto& dir : options.repositoryDirs) {
+        for (const auto& name : listRepositoryFiles(dir)) {
+            if (!seenFiles.insert(name).second) {
+                continue;
+            }
+            std::string path = dir + "/" + name;
+            std::vector<RepositoryConfig> parsed = parseRepositoryFile(readFileContents(path), path);
+            result.insert(result.end(), parsed.begin(), parsed.end());
+        }
+    }
+    return result;
+}
+
+bool PackageState::isRepositoryEnabled(const std::string& repositoryId) const {
+    for (const auto& repository : repositories()) {
+        if (repository.enabled && repository.id.find(repositoryId) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string PackageState::releaseVersion() const {
+    std::map<std::string, std::string> fields;
+    std::istringstream stream(readFileContents(options.osRelease));
+    std::string line;
+    while (std::getline(stream, line)) {
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            continue;
+        }
+        std::string value = trim(line.substr(equals + 1));
+        if (value.size() >= 2 && (value.front() == '"' || value.front() == '\'') && value.back() == value.front()) {
+            value = value.substr(1, value.size() - 2);
+        }
+        fields[trim(line.substr(0, equals))] = value;
+    }
+    
+    // Pochodne Fedory mają własną numerację; dla nich wersję poda rpm -E %fedora
+    return fields["ID"] == "fedora" ? fields["VERSION_ID"] : "";
+}
+
+bool PackageState::hasNativeRpmQueries() {
+#ifdef HAVE_LIBRPM
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool PackageState::installedVersions(const std::vector<std::string>& packages,
+                                     std::map<std::string, std::string>& versions) const {
+#ifdef HAVE_LIBRPM
+    // Makra rpm (m.in. położenie bazy) wczytywane raz na proces
+    static std::once_flag configured;
+    static bool configOk = false;
+    std::call_once(configured, []() {
+        configOk = rpmReadConfigFiles(nullptr, nullptr) == 0;
+    });
+    if (!configOk) {
+        return false;
+    }
+    
+    rpmts transactionSet = rpmtsCreate();
+    rpmtsSetRootDir(transactionSet, options.rpmRoot.c_str());
+    versions.clear();
+    for (const auto& package : packages) {
+        rpmdbMatchIterator iterator = rpmtsInitIterator(transactionSet, RPMDBI_NAME, package.c_str(), 0);
+        while (Header header = rpmdbNextIterator(iterator)) {
+            // Ten sam format co zapytanie rpm -q --qf w DnfBackend
+            errmsg_t error = nullptr;
+            char* version = headerFormat(header, "%{EPOCHNUM}:%{VERSION}-%{RELEASE}.%{ARCH}", &error);
+            if (version) {
+                versions[package] = version;
+                std::free(version);
+            }
+        }
+        rpmdbFreeIterator(iterator);
+    }
+    rpmtsFree(transactionSet);
+    return true;
+#else
+    (void)packages;
+    (void)versions;
+    return false;
+#endif
+}
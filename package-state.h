@@ -0,0 +1,49 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+// Położenie plików stanu pakietów (można wskazać drzewo testowe)
+struct PackageStateOptions {
+    // Katalogi plików .repo; plik o tej samej nazwie we wcześniejszym katalogu przesłania późniejszy
+    std::vector<std::string> repositoryDirs = {"/etc/yum.repos.d", "/etc/distro.repos.d", "/usr/share/dnf5/repos.d"};
+    std::string osRelease = "/etc/os-release";
+    std::string rpmRoot = "/";  // Katalog główny bazy rpm (tylko z librpm)
+};
+
+// Repozytorium z pliku .repo
+struct RepositoryConfig {
+    std::string id;        // Nazwa sekcji (np. rpmfusion-nonfree)
+    std::string name;
+    bool enabled = true;   // Bez klucza enabled repozytorium jest włączone
+    std::string file;
+};
+
+// Stan repozytoriów i zainstalowanych pakietów odczytywany w procesie: pliki .repo
+// zamiast dnf repolist (bez pobierania metadanych) i baza rpm przez librpm
+class PackageState {
+private:
+    PackageStateOptions options;
+
+public:
+    explicit PackageState(PackageStateOptions options = PackageStateOptions());
+    
+    std::vector<RepositoryConfig> repositories() const;
+    
+    // Czy włączone jest repozytorium, którego identyfikator zawiera podany ciąg
+    bool isRepositoryEnabled(const std::string& repositoryId) const;
+    
+    // VERSION_ID z os-release, jeśli ID=fedora (w przeciwnym razie pusty ciąg)
+    std::string releaseVersion() const;
+    
+    // Wersje (EPOCHNUM:VERSION-RELEASE.ARCH) zainstalowanych pakietów z bazy rpm.
+    // Wymaga librpm; bez niej zwraca false i zapytanie trzeba wykonać przez rpm -q.
+    bool installedVersions(const std::vector<std::string>& packages, std::map<std::string, std::string>& versions) const;
+    
+    // Czy program zbudowano z librpm (HAVE_LIBRPM)
+    static bool hasNativeRpmQueries();
+    
+    // Parsowanie zawartości pliku .repo (format INI)
+    static std::vector<RepositoryConfig> parseRepositoryFile(const std::string& text, const std::string& file);
+};
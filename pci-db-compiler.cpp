@@ -0,0 +1,125 @@
+// Generator bazy PCI -> gałąź sterownika uruchamiany przy budowaniu:
+// pci-db-compiler <pci-driver-db.txt> <pci-driver-db.bin>
+// Sprawdzenie skompilowanej bazy z nazwami układów NVIDIA w hwdata:
+// pci-db-compiler --check <pci-driver-db.bin> <pci.ids>
+
+#include <cctype>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "driver-database.h"
+#include "file-utils.h"
+#include "pci-names.h"
+
+namespace {
+
+// Gałąź wynikająca z rodziny układu na początku nazwy w pci.ids (np. "GF108 [GeForce GT 630]");
+// false dla nazw bez oznaczenia układu i funkcji, które nie są kartą graficzną (audio HDMI, USB-C)
+bool expectedNvidiaBranch(const std::string& name, DriverType& type) {
+    for (const char* function : {"Audio", "USB", "UCSI", "Bridge", "bridge", "SMBus", "Ethernet", "SATA", "IDE",
+                                 "LPC", "Host", "Memory", "Serial", "Coprocessor", "Network", "Modem", "PCI Express"}) {
+        if (name.find(function) != std::string::npos) {
+            return false;
+        }
+    }
+    
+    std::string chip = name.substr(0, name.find(' '));
+    auto family = [&chip](const std::string& prefix) {
+        return chip.size() > prefix.size() && chip.compare(0, prefix.size(), prefix) == 0 &&
+               std::isdigit(static_cast<unsigned char>(chip[prefix.size()]));
+    };
+    
+    if (family("GF")) {
+        type = DriverType::NVIDIA_LEGACY_390;
+    } else if (family("GK")) {
+        type = DriverType::NVIDIA_LEGACY_470;
+    } else if (family("GM") || family("GP") || family("GV") || family("TU") || family("GA") || family("AD") ||
+               family("GH") || family("GB")) {
+        type = DriverType::NVIDIA_PROPRIETARY;
+    } else if (family("NV") || family("G") || family("GT") || family("C") || family("MCP")) {
+        type = DriverType::NVIDIA_NOUVEAU;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Urządzenia NVIDIA z pci.ids, dla których baza wskazuje inną gałąź niż rodzina układu
+int checkAgainstPciIds(const std::string& databasePath, const std::string& pciIdsPath) {
+    PciDriverDatabase database;
+    if (!database.open(databasePath)) {
+        std::cerr << "Nie można otworzyć bazy " << databasePath << std::endl;
+        return 2;
+    }
+    PciNames names;
+    if (!names.load(pciIdsPath)) {
+        std::cerr << "Nie można wczytać " << pciIdsPath << std::endl;
+        return 2;
+    }
+    
+    const uint16_t nvidia = 0x10de;
+    size_t checked = 0, mismatches = 0;
+    for (const auto& device : names.vendorDevices(nvidia)) {
+        DriverType expected;
+        if (!expectedNvidiaBranch(device.second, expected)) {
+            continue;
+        }
+        ++checked;
+        
+        DriverType actual = DriverType::UNKNOWN;
+        if (!database.lookupDevice(nvidia, device.first, actual)) {
+            database.lookupVendor(nvidia, actual);
+        }
+        if (actual != expected) {
+            char id[8];
+            std::snprintf(id, sizeof(id), "%04x", device.first);
+            std::cout << "10de:" << id << " " << device.second << ": " << driverTypeName(actual)
+                      << ", oczekiwano " << driverTypeName(expected) << std::endl;
+            ++mismatches;
+        }
+    }
+    
+    std::cout << "Sprawdzone układy NVIDIA: " << checked << ", niezgodne: " << mismatches << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 4 && std::string(argv[1]) == "--check") {
+        return checkAgainstPciIds(argv[2], argv[3]);
+    }
+    if (argc != 3) {
+        std::cerr << "Użycie: " << argv[0] << " <plik źródłowy> <plik wynikowy>" << std::endl;
+        std::cerr << "        " << argv[0] << " --check <plik wynikowy> <pci.ids>" << std::endl;
+        return 2;
+    }
+    
+    PciDriverDatabaseBuilder builder;
+    std::string error;
+    if (!builder.parseSource(readFileContents(argv[1]), error)) {
+        std::cerr << argv[1] << ": " << error << std::endl;
+        return 1;
+    }
+    
+    std::string database = builder.build();
+    if (database.empty()) {
+        std::cerr << "Nie udało się zbudować doskonałego skrótu dla " << builder.size() << " identyfikatorów" << std::endl;
+        return 1;
+    }
+    
+    // Sprawdzenie wyniku czytnikiem używanym przez instalator
+    if (!writeFileAtomically(argv[2], database)) {
+        std::cerr << "Nie można zapisać " << argv[2] << std::endl;
+        return 1;
+    }
+    PciDriverDatabase check;
+    if (!check.open(argv[2])) {
+        std::cerr << "Zapisana baza jest niepoprawna: " << argv[2] << std::endl;
+        return 1;
+    }
+    
+    std::cout << "Baza sterowników: " << builder.size() << " identyfikatorów, " << database.size() << " bajtów" << std::endl;
+    return 0;
+}
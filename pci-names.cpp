@@ -0,0 +1,73 @@
+#include "pci-names.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+
+// Cztery cyfry szesnastkowe na początku tekstu
+bool parseHexId(const std::string& text, size_t offset, uint16_t& id) {
+    if (text.size() < offset + 4) {
+        return false;
+    }
+    char* end = nullptr;
+    std::string digits = text.substr(offset, 4);
+    unsigned long value = std::strtoul(digits.c_str(), &end, 16);
+    if (end != digits.c_str() + 4) {
+        return false;
+    }
+    id = static_cast<uint16_t>(value);
+    return true;
+}
+
+}
+
+bool PciNames::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    
+    // Format: "vvvv  Producent", "\tdddd  Urządzenie", "\t\tssss ssss  Podsystem", na końcu klasy "C xx"
+    std::string line;
+    uint16_t vendorId = 0;
+    bool inVendor = false;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (line[0] == 'C' && line.size() > 1 && line[1] == ' ') {
+            break;
+        }
+        if (line[0] != '\t') {
+            inVendor = parseHexId(line, 0, vendorId);
+            continue;
+        }
+        uint16_t deviceId;
+        if (!inVendor || line.size() < 8 || line[1] == '\t' || !parseHexId(line, 1, deviceId)) {
+            continue;
+        }
+        size_t name = line.find_first_not_of(' ', 5);
+        if (name != std::string::npos) {
+            devices[static_cast<uint32_t>(vendorId) << 16 | deviceId] = line.substr(name);
+        }
+    }
+    return !devices.empty();
+}
+
+std::string PciNames::lookup(uint16_t vendorId, uint16_t deviceId) const {
+    auto it = devices.find(static_cast<uint32_t>(vendorId) << 16 | deviceId);
+    return it == devices.end() ? "" : it->second;
+}
+
+std::vector<std::pair<uint16_t, std::string>> PciNames::vendorDevices(uint16_t vendorId) const {
+    std::vector<std::pair<uint16_t, std::string>> result;
+    for (const auto& entry : devices) {
+        if (entry.first >> 16 == vendorId) {
+            result.emplace_back(static_cast<uint16_t>(entry.first & 0xffff), entry.second);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
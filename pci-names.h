@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Nazwy urządzeń z bazy hwdata (pci.ids), tej samej, której używa lspci
+class PciNames {
+private:
+    std::unordered_map<uint32_t, std::string> devices;   // (producent << 16 | urządzenie) -> nazwa
+
+public:
+    static constexpr const char* defaultPath = "/usr/share/hwdata/pci.ids";
+    
+    // Wczytanie nazw urządzeń (bez podsystemów i klas); false, jeśli plik jest nieczytelny
+    bool load(const std::string& path);
+    
+    // Nazwa urządzenia (np. "GP107M [GeForce GTX 1050 Mobile]"); pusta, jeśli nieznana
+    std::string lookup(uint16_t vendorId, uint16_t deviceId) const;
+    
+    // Wszystkie urządzenia producenta posortowane według identyfikatora (np. do sprawdzania bazy sterowników)
+    std::vector<std::pair<uint16_t, std::string>> vendorDevices(uint16_t vendorId) const;
+    
+    bool empty() const { return devices.empty(); }
+};
@@ -0,0 +1,192 @@
+#include "pci-scanner.h"
+#include "file-utils.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <utility>
+
+// Dla operacji na katalogach
+#include <dirent.h>
+
+PciScanner::PciScanner(std::string sysfsRoot) : sysfsRoot(std::move(sysfsRoot)) {
+}
+
+std::vector<PciDevice> PciScanner::scan() const {
+    std::vector<PciDevice> devices;
+    
+    DIR* dir = opendir((sysfsRoot + "/bus/pci/devices").c_str());
+    if (!dir) {
+        return devices;
+    }
+    
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        
+        PciDevice device;
+        if (readDevice(entry->d_name, device)) {
+            devices.push_back(device);
+        }
+    }
+    closedir(dir);
+    
+    // Kolejność readdir nie jest określona, a wynik ma być powtarzalny
+    std::sort(devices.begin(), devices.end(), [](const PciDevice& a, const PciDevice& b) {
+        return a.slot < b.slot;
+    });
+    
+    return devices;
+}
+
+std::vector<PciDevice> PciScanner::scanDisplayControllers() const {
+    std::vector<PciDevice> devices = scan();
+    devices.erase(std::remove_if(devices.begin(), devices.end(), [](const PciDevice& device) {
+        return !device.isDisplayController();
+    }), devices.end());
+    return devices;
+}
+
+bool PciScanner::readDevice(const std::string& slot, PciDevice& device) const {
+    std::string path = devicePath(slot);
+    unsigned long value = 0;
+    
+    device.slot = slot;
+    
+    if (!readHexAttribute(path + "/class", value)) {
+        return false;
+    }
+    device.classCode = static_cast<uint32_t>(value);
+    
+    if (!readHexAttribute(path + "/vendor", value)) {
+        return false;
+    }
+    device.vendorId = static_cast<uint16_t>(value);
+    
+    if (!readHexAttribute(path + "/device", value)) {
+        return false;
+    }
+    device.deviceId = static_cast<uint16_t>(value);
+    
+    // Atrybuty podsystemu i boot_vga są opcjonalne (boot_vga istnieje tylko dla kart VGA)
+    if (readHexAttribute(path + "/subsystem_vendor", value)) {
+        device.subsystemVendorId = static_cast<uint16_t>(value);
+    }
+    if (readHexAttribute(path + "/subsystem_device", value)) {
+        device.subsystemDeviceId = static_cast<uint16_t>(value);
+    }
+    device.bootVga = readFirstLine(path + "/boot_vga") == "1";
+    std::string numaNode = readFirstLine(path + "/numa_node");
+    if (!numaNode.empty()) {
+        device.numaNode = std::atoi(numaNode.c_str());
+    }
+    
+    return true;
+}
+
+std::string PciScanner::devicePath(const std::string& slot) const {
+    return sysfsRoot + "/bus/pci/devices/" + slot;
+}
+
+std::string PciScanner::className(uint32_t classCode) {
+    switch ((classCode >> 8) & 0xffff) {
+        case 0x0300: return "VGA compatible controller";
+        case 0x0301: return "XGA compatible controller";
+        case 0x0302: return "3D controller";
+        default:     return "Display controller";
+    }
+}
+
+std::string PciScanner::formatId(uint16_t vendorId, uint16_t deviceId) {
+    char buffer[10];
+    std::snprintf(buffer, sizeof(buffer), "%04x:%04x", vendorId, deviceId);
+    return buffer;
+}
+
+namespace {
+
+// Ostatni identyfikator w nawiasach [vvvv:dddd] w wierszu lspci
+bool parseBracketedId(const std::string& line, uint16_t& vendorId, uint16_t& deviceId) {
+    size_t end = line.size();
+    while (end > 0) {
+        size_t open = line.rfind('[', end - 1);
+        if (open == std::string::npos) {
+            return false;
+        }
+        std::string id = line.substr(open + 1, 10);
+        unsigned vendor, device;
+        char close;
+        if (id.size() == 10 && std::sscanf(id.c_str(), "%4x:%4x%c", &vendor, &device, &close) == 3 && close == ']') {
+            vendorId = static_cast<uint16_t>(vendor);
+            deviceId = static_cast<uint16_t>(device);
+            return true;
+        }
+        end = open;
+    }
+    return false;
+}
+
+}
+
+std::vector<PciDevice> PciScanner::parseLspciOutput(const std::string& text) {
+    std::vector<PciDevice> devices;
+    std::istringstream stream(text);
+    std::string line;
+    bool lastParsed = false;
+    
+    while (std::getline(stream, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        
+        // Wiersze szczegółów (-k, -v) są wcięte; liczy się tylko Subsystem
+        if (line[0] == ' ' || line[0] == '\t') {
+            size_t subsystem = line.find("Subsystem:");
+            if (lastParsed && subsystem != std::string::npos) {
+                parseBracketedId(line.substr(subsystem), devices.back().subsystemVendorId,
+                                 devices.back().subsystemDeviceId);
+            }
+            continue;
+        }
+        lastParsed = false;
+        
+        // <slot> <klasa> [cccc]: <opis> [vvvv:dddd] (rev xx)
+        size_t space = line.find(' ');
+        size_t classEnd = line.find("]: ");
+        if (space == std::string::npos || classEnd == std::string::npos || classEnd < space) {
+            continue;
+        }
+        size_t classStart = line.rfind('[', classEnd);
+        unsigned classCode;
+        if (classStart == std::string::npos || classEnd - classStart != 5 ||
+            std::sscanf(line.c_str() + classStart + 1, "%4x", &classCode) != 1) {
+            continue;
+        }
+        
+        PciDevice device;
+        device.slot = line.substr(0, space);
+        if (std::count(device.slot.begin(), device.slot.end(), ':') == 1) {
+            device.slot = "0000:" + device.slot;  // lspci bez -D pomija domenę
+        }
+        device.classCode = classCode << 8;
+        if (!parseBracketedId(line.substr(classEnd), device.vendorId, device.deviceId)) {
+            continue;
+        }
+        size_t idStart = line.rfind("[" + formatId(device.vendorId, device.deviceId) + "]");
+        if (idStart > classEnd + 3) {
+            device.description = line.substr(classEnd + 3, idStart - classEnd - 3);
+            while (!device.description.empty() && device.description.back() == ' ') {
+                device.description.pop_back();
+            }
+        }
+        devices.push_back(device);
+        lastParsed = true;
+    }
+    
+    std::sort(devices.begin(), devices.end(), [](const PciDevice& a, const PciDevice& b) {
+        return a.slot < b.slot;
+    });
+    return devices;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Urządzenie PCI odczytane bezpośrednio z sysfs
+struct PciDevice {
+    std::string slot;                // Adres BDF (np. 0000:01:00.0)
+    uint32_t classCode = 0;          // Kod klasy PCI (np. 0x030000)
+    uint16_t vendorId = 0;           // ID producenta (np. 0x10de)
+    uint16_t deviceId = 0;           // ID urządzenia
+    uint16_t subsystemVendorId = 0;  // ID producenta podsystemu (np. producent laptopa)
+    uint16_t subsystemDeviceId = 0;  // ID urządzenia podsystemu
+    bool bootVga = false;            // Czy firmware użył tej karty przy starcie systemu
+    int numaNode = -1;               // Węzeł NUMA (-1: brak informacji lub system jednowęzłowy)
+    std::string description;         // Opis z wyjścia lspci (producent i model); z sysfs pusty
+    
+    // Czy to kontroler wyświetlania (klasa 0x03: VGA, XGA, 3D, inne)
+    bool isDisplayController() const {
+        return (classCode >> 16) == 0x03;
+    }
+};
+
+// Wyliczanie urządzeń PCI przez /sys/bus/pci/devices bez lspci i bez powłoki
+class PciScanner {
+private:
+    std::string sysfsRoot;
+
+public:
+    // Katalog główny sysfs można podmienić, np. na drzewo testowe
+    explicit PciScanner(std::string sysfsRoot = "/sys");
+    
+    // Wszystkie urządzenia PCI posortowane według adresu
+    std::vector<PciDevice> scan() const;
+    
+    // Tylko kontrolery wyświetlania (karty graficzne)
+    std::vector<PciDevice> scanDisplayControllers() const;
+    
+    // Odczytanie pojedynczego urządzenia (false, jeśli katalog nie zawiera atrybutów PCI)
+    bool readDevice(const std::string& slot, PciDevice& device) const;
+    
+    // Ścieżka do katalogu urządzenia w sysfs
+    std::string devicePath(const std::string& slot) const;
+    
+    // Czytelna nazwa klasy kontrolera wyświetlania
+    static std::string className(uint32_t classCode);
+    
+    // Identyfikator w formacie lspci (np. 10de:1c8d)
+    static std::string formatId(uint16_t vendorId, uint16_t deviceId);
+    
+    // Urządzenia z wyjścia lspci -nn (także -nnk/-nnv: uwzględniany jest wiersz Subsystem).
+    // Wiersze bez identyfikatorów w nawiasach są pomijane; boot_vga nie jest znane.
+    // Opis urządzenia jest zachowywany jako zapasowa nazwa modelu.
+    static std::vector<PciDevice> parseLspciOutput(const std::string& text);
+};
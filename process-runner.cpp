@@ -0,0 +1,277 @@
+#include "process-runner.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+// Dla posix_spawn, potoków i sygnałów
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace {
+
+// Bufor odczytu jednego strumienia z podziałem na linie dla wywołania zwrotnego
+struct StreamState {
+    int fd = -1;
+    ProcessStream stream;
+    std::string* captured;
+    std::string partial;
+};
+
+void deliverLines(StreamState& state, const char* data, size_t size, const ProcessOptions& options) {
+    if (options.captureOutput) {
+        state.captured->append(data, size);
+    }
+    if (!options.onLine) {
+        return;
+    }
+    
+    state.partial.append(data, size);
+    size_t start = 0;
+    size_t newline;
+    while ((newline = state.partial.find('\n', start)) != std::string::npos) {
+        options.onLine(state.stream, state.partial.substr(start, newline - start + 1));
+        start = newline + 1;
+    }
+    state.partial.erase(0, start);
+}
+
+// Czy na deskryptorze przerwania czeka żądanie (bez blokowania)
+bool cancelRequested(int fd) {
+    if (fd < 0) {
+        return false;
+    }
+    pollfd descriptor = {fd, POLLIN, 0};
+    return poll(&descriptor, 1, 0) > 0 && (descriptor.revents & POLLIN);
+}
+
+}
+
+ProcessResult ProcessRunner::run(const std::vector<std::string>& argv, const ProcessOptions& options) {
+    using Clock = std::chrono::steady_clock;
+    ProcessResult result;
+    const auto started = Clock::now();
+    
+    if (argv.empty()) {
+        return result;
+    }
+    
+    // Przerwana instalacja nie uruchamia już kolejnych poleceń
+    if (cancelRequested(options.cancelFd)) {
+        result.cancelled = true;
+        return result;
+    }
+    
+    int stdoutPipe[2];
+    int stderrPipe[2];
+    if (pipe2(stdoutPipe, O_CLOEXEC) != 0) {
+        return result;
+    }
+    if (pipe2(stderrPipe, O_CLOEXEC) != 0) {
+        close(stdoutPipe[0]);
+        close(stdoutPipe[1]);
+        return result;
+    }
+    
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, stdoutPipe[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, stderrPipe[1], STDERR_FILENO);
+    
+    // Własna grupa procesów pozwala zabić również procesy potomne polecenia
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    sigset_t defaultSignals;
+    sigemptyset(&defaultSignals);
+    sigaddset(&defaultSignals, SIGPIPE);
+    sigset_t emptyMask;
+    sigemptyset(&emptyMask);
+    posix_spawnattr_setsigdefault(&attributes, &defaultSignals);
+    posix_spawnattr_setsigmask(&attributes, &emptyMask);
+    posix_spawnattr_setpgroup(&attributes, 0);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK);
+    
+    std::vector<char*> arguments;
+    for (const auto& arg : argv) {
+        arguments.push_back(const_cast<char*>(arg.c_str()));
+    }
+    arguments.push_back(nullptr);
+    
+    // Dodatkowe zmienne zastępują odziedziczone o tej samej nazwie
+    std::vector<char*> environment;
+    for (char** entry = environ; entry && *entry; ++entry) {
+        std::string name(*entry, std::strcspn(*entry, "="));
+        bool overridden = std::any_of(options.environment.begin(), options.environment.end(), [&name](const std::string& extra) {
+            return extra.compare(0, name.size() + 1, name + "=") == 0;
+        });
+        if (!overridden) {
+            environment.push_back(*entry);
+        }
+    }
+    for (const auto& entry : options.environment) {
+        environment.push_back(const_cast<char*>(entry.c_str()));
+    }
+    environment.push_back(nullptr);
+    
+    pid_t pid = -1;
+    int spawnError = posix_spawnp(&pid, arguments[0], &actions, &attributes, arguments.data(), environment.data());
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attributes);
+    close(stdoutPipe[1]);
+    close(stderrPipe[1]);
+    
+    if (spawnError != 0) {
+        close(stdoutPipe[0]);
+        close(stderrPipe[0]);
+        result.standardError = std::string(argv[0]) + ": " + std::strerror(spawnError) + "\n";
+        result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - started);
+        return result;
+    }
+    result.started = true;
+    
+    StreamState streams[2] = {
+        {stdoutPipe[0], ProcessStream::STDOUT, &result.standardOutput, ""},
+        {stderrPipe[0], ProcessStream::STDERR, &result.standardError, ""}
+    };
+    
+    const bool hasDeadline = options.timeout.count() > 0;
+    const auto deadline = started + options.timeout;
+    auto killAt = Clock::time_point::max();
+    bool exited = false;
+    int status = 0;
+    std::vector<char> buffer(64 * 1024);
+    
+    // SIGTERM do całej grupy, a po killGrace SIGKILL (limit czasu i przerwanie na żądanie)
+    auto terminate = [&](Clock::time_point now) {
+        kill(-pid, SIGTERM);
+        killAt = now + options.killGrace;
+    };
+    
+    while (streams[0].fd >= 0 || streams[1].fd >= 0) {
+        pollfd descriptors[3];
+        nfds_t count = 0;
+        StreamState* polled[2];
+        for (auto& state : streams) {
+            if (state.fd >= 0) {
+                descriptors[count] = {state.fd, POLLIN, 0};
+                polled[count++] = &state;
+            }
+        }
+        nfds_t streamCount = count;
+        if (options.cancelFd >= 0 && !result.cancelled) {
+            descriptors[count++] = {options.cancelFd, POLLIN, 0};
+        }
+        
+        // Krótkie odcinki pozwalają sprawdzać limit czasu i zakończenie procesu,
+        // nawet gdy potomek procesu trzyma potoki otwarte
+        int waitMillis = 200;
+        auto now = Clock::now();
+        if (hasDeadline && !result.timedOut) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+            waitMillis = static_cast<int>(std::max<long long>(0, std::min<long long>(waitMillis, left)));
+        }
+        
+        int ready = poll(descriptors, count, waitMillis);
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+        
+        for (nfds_t i = 0; ready > 0 && i < streamCount; ++i) {
+            if (!(descriptors[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                continue;
+            }
+            ssize_t size = read(polled[i]->fd, buffer.data(), buffer.size());
+            if (size > 0) {
+                deliverLines(*polled[i], buffer.data(), static_cast<size_t>(size), options);
+            } else if (size == 0 || errno != EINTR) {
+                close(polled[i]->fd);
+                polled[i]->fd = -1;
+            }
+        }
+        
+        now = Clock::now();
+        if (ready > 0 && count > streamCount && (descriptors[streamCount].revents & POLLIN)) {
+            result.cancelled = true;
+            terminate(now);
+        }
+        if (hasDeadline && !result.timedOut && now >= deadline) {
+            result.timedOut = true;
+            terminate(now);
+        }
+        if (now >= killAt) {
+            kill(-pid, SIGKILL);
+            killAt = Clock::time_point::max();
+        }
+        
+        if (!exited && waitpid(pid, &status, WNOHANG) == pid) {
+            exited = true;
+        }
+        if (exited) {
+            // Proces się zakończył: odczyt reszty danych bez czekania na procesy, które odziedziczyły potoki
+            for (auto& state : streams) {
+                if (state.fd < 0) {
+                    continue;
+                }
+                fcntl(state.fd, F_SETFL, O_NONBLOCK);
+                ssize_t size;
+                while ((size = read(state.fd, buffer.data(), buffer.size())) > 0) {
+                    deliverLines(state, buffer.data(), static_cast<size_t>(size), options);
+                }
+                close(state.fd);
+                state.fd = -1;
+            }
+        }
+    }
+    
+    // Potoki zamknięte, ale proces może nadal działać; limit czasu i przerwanie obowiązują dalej
+    while (!exited) {
+        if (!hasDeadline && options.cancelFd < 0) {
+            if (waitpid(pid, &status, 0) == pid || errno != EINTR) {
+                exited = true;
+            }
+            continue;
+        }
+        
+        if (waitpid(pid, &status, WNOHANG) == pid) {
+            exited = true;
+            continue;
+        }
+        
+        auto now = Clock::now();
+        if (!result.cancelled && cancelRequested(options.cancelFd)) {
+            result.cancelled = true;
+            terminate(now);
+        }
+        if (hasDeadline && !result.timedOut && now >= deadline) {
+            result.timedOut = true;
+            terminate(now);
+        }
+        if (now >= killAt) {
+            kill(-pid, SIGKILL);
+            killAt = Clock::time_point::max();
+        }
+        usleep(10 * 1000);
+    }
+    
+    // Ostatnia linia bez znaku nowej linii
+    for (auto& state : streams) {
+        if (options.onLine && !state.partial.empty()) {
+            options.onLine(state.stream, state.partial);
+        }
+    }
+    
+    if (WIFEXITED(status)) {
+        result.exitCode = WEXITSTATUS(status);
+    } else if (WIFSIGNALED(status)) {
+        result.signal = WTERMSIG(status);
+    }
+    result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - started);
+    return result;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Strumień wyjściowy procesu potomnego
+enum class ProcessStream {
+    STDOUT,
+    STDERR
+};
+
+// Ustawienia uruchomienia procesu
+struct ProcessOptions {
+    std::chrono::milliseconds timeout{0};              // Limit czasu (0: bez limitu)
+    std::chrono::milliseconds killGrace{2000};         // Czas między SIGTERM a SIGKILL po przekroczeniu limitu
+    std::vector<std::string> environment;              // Dodatkowe zmienne środowiska (KLUCZ=wartość)
+    int cancelFd = -1;                                 // Gotowość do odczytu przerywa proces jak limit czasu
+    bool captureOutput = true;                         // false: wyjście tylko dla onLine, bez zapisu w wyniku
+    // Kolejne linie wyjścia (z końcowym \n, jeśli występował) w trakcie działania procesu
+    std::function<void(ProcessStream stream, const std::string& line)> onLine;
+};
+
+// Wynik działania procesu
+struct ProcessResult {
+    bool started = false;                   // Czy udało się uruchomić program
+    int exitCode = -1;                      // Kod wyjścia (-1 przy zakończeniu sygnałem)
+    int signal = 0;                         // Sygnał, który zakończył proces (0: brak)
+    bool timedOut = false;                  // Czy proces zabito po przekroczeniu limitu czasu
+    bool cancelled = false;                 // Czy proces zabito na żądanie (cancelFd)
+    std::chrono::milliseconds duration{0};  // Czas działania
+    std::string standardOutput;
+    std::string standardError;
+};
+
+// Uruchamianie programów przez posix_spawn (bez powłoki) z jednoczesnym odczytem
+// stdout i stderr przez poll oraz zabijaniem całej grupy procesów po przekroczeniu limitu lub na żądanie
+class ProcessRunner {
+public:
+    static ProcessResult run(const std::vector<std::string>& argv, const ProcessOptions& options = ProcessOptions());
+};
@@ -0,0 +1,112 @@
+#include "progress-client.h"
+#include "json-utils.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+// Dla gniazd Unix
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+ProgressClient::~ProgressClient() {
+    disconnect();
+}
+
+bool ProgressClient::connect(const std::string& path) {
+    disconnect();
+    
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        disconnect();
+        return false;
+    }
+    return true;
+}
+
+void ProgressClient::disconnect() {
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+    input.clear();
+}
+
+bool ProgressClient::receive(std::vector<std::string>& events) {
+    if (fd < 0) {
+        return false;
+    }
+    
+    char buffer[4096];
+    ssize_t size;
+    while ((size = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT)) < 0 && errno == EINTR) {
+    }
+    if (size == 0 || (size < 0 && errno != EAGAIN)) {
+        return false;
+    }
+    if (size > 0) {
+        input.append(buffer, static_cast<size_t>(size));
+    }
+    
+    size_t newline;
+    while ((newline = input.find('\n')) != std::string::npos) {
+        events.push_back(input.substr(0, newline));
+        input.erase(0, newline + 1);
+    }
+    return true;
+}
+
+bool ProgressClient::send(const std::string& command) {
+    std::string line = "{\"command\":\"" + escapeJson(command) + "\"}\n";
+    return fd >= 0 && ::send(fd, line.data(), line.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(line.size());
+}
+
+std::string ProgressClient::describe(const std::string& event) {
+    std::string type = jsonStringField(event, "event");
+    std::string phase = jsonStringField(event, "phase");
+    std::string message = jsonStringField(event, "message");
+    
+    if (type == "package") {
+        std::string text = "[" + phase + "] " + jsonStringField(event, "package");
+        double value;
+        char buffer[64];
+        if (jsonNumberField(event, "percent", value)) {
+            std::snprintf(buffer, sizeof(buffer), " %.0f%%", value);
+            text += buffer;
+        }
+        if (jsonNumberField(event, "bytes", value)) {
+            std::snprintf(buffer, sizeof(buffer), ", %.1f MiB", value / 1048576.0);
+            text += buffer;
+        }
+        if (jsonNumberField(event, "eta", value)) {
+            std::snprintf(buffer, sizeof(buffer), ", pozostało ok. %.0f s", value);
+            text += buffer;
+        }
+        return text;
+    }
+    if (type == "phase") {
+        return "== " + (message.empty() ? phase : message);
+    }
+    if (type == "prompt") {
+        return message + " (t/n): ";
+    }
+    if (type == "result") {
+        return (event.find("\"success\":true") != std::string::npos ? "Zakończono: " : "Niepowodzenie: ") + message;
+    }
+    if (type == "answer") {
+        return "Odpowiedź: " + message;
+    }
+    return message.empty() ? event : message;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Klient gniazda postępu instalatora (dla interfejsu graficznego i trybu --watch).
+// Zdarzenia są odczytywane bez blokowania, więc deskryptor można obsługiwać we własnej pętli poll.
+class ProgressClient {
+private:
+    int fd = -1;
+    std::string input;    // Niepełna linia zdarzenia
+
+public:
+    ProgressClient() = default;
+    ~ProgressClient();
+    
+    ProgressClient(const ProgressClient&) = delete;
+    ProgressClient& operator=(const ProgressClient&) = delete;
+    
+    bool connect(const std::string& path);
+    void disconnect();
+    
+    // Deskryptor do poll (POLLIN: są nowe zdarzenia)
+    int descriptor() const { return fd; }
+    
+    // Odczyt dostępnych zdarzeń (linie JSON bez \n); false, gdy instalator zamknął połączenie
+    bool receive(std::vector<std::string>& events);
+    
+    // Polecenie: confirm, decline lub cancel
+    bool send(const std::string& command);
+    
+    // Czytelny opis zdarzenia do wypisania w terminalu
+    static std::string describe(const std::string& event);
+};
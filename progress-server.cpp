@@ -0,0 +1,285 @@
+#include "progress-server.h"
+#include "json-utils.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// Dla gniazd Unix, eventfd i grup
+#include <fcntl.h>
+#include <grp.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// Bufor niewysłanych zdarzeń, po którego przekroczeniu klient jest rozłączany
+const size_t maxPendingOutput = 1 << 20;
+
+void signalEvent(int fd) {
+    uint64_t value = 1;
+    ssize_t written = write(fd, &value, sizeof(value));
+    (void)written;
+}
+
+void drainEvent(int fd) {
+    uint64_t value;
+    ssize_t size = read(fd, &value, sizeof(value));
+    (void)size;
+}
+
+bool fillAddress(const std::string& path, sockaddr_un& address) {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    return true;
+}
+
+}
+
+ProgressServer::ProgressServer(std::string path) : path(std::move(path)) {
+}
+
+ProgressServer::~ProgressServer() {
+    stop();
+}
+
+bool ProgressServer::start(CommandCallback callback) {
+    sockaddr_un address;
+    if (!fillAddress(path, address)) {
+        return false;
+    }
+    
+    // Plik gniazda po poprzednim przebiegu jest usuwany; gniazdo, które odpowiada, należy do innego instalatora
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe >= 0) {
+        bool inUse = connect(probe, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        close(probe);
+        if (inUse) {
+            return false;
+        }
+    }
+    unlink(path.c_str());
+    
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (listenFd < 0) {
+        return false;
+    }
+    
+    // Przerwanie instalacji i odpowiedzi na pytania tylko dla roota i administratorów (grupa wheel).
+    // Uprawnienia są ustawiane przed listen(), bo do tego czasu nikt nie może się połączyć; umask
+    // nie jest zmieniany, bo dotyczy całego procesu, a wątki logów i pobierania tworzą już pliki.
+    bound = bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    bool restricted = false;
+    if (bound) {
+        group* wheel = getgrnam("wheel");
+        if (wheel && chown(path.c_str(), 0, wheel->gr_gid) == 0) {
+            restricted = chmod(path.c_str(), 0660) == 0;
+        } else {
+            restricted = chmod(path.c_str(), 0600) == 0;
+        }
+    }
+    if (!restricted || listen(listenFd, 8) != 0) {
+        close(listenFd);
+        listenFd = -1;
+        if (bound) {
+            unlink(path.c_str());
+            bound = false;
+        }
+        return false;
+    }
+    
+    wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    answerFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK | EFD_SEMAPHORE);
+    onCommand = std::move(callback);
+    stopping = false;
+    worker = std::thread(&ProgressServer::run, this);
+    return true;
+}
+
+void ProgressServer::stop() {
+    if (worker.joinable()) {
+        stopping = true;
+        signalEvent(wakeFd);
+        worker.join();
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : clients) {
+        close(entry.first);
+    }
+    clients.clear();
+    for (int* fd : {&listenFd, &wakeFd, &answerFd}) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+    // Gniazdo innego działającego instalatora (start() zwrócił false) musi pozostać
+    if (bound) {
+        unlink(path.c_str());
+        bound = false;
+    }
+}
+
+void ProgressServer::publish(const ProgressEvent& event) {
+    std::string line = progressEventJson(event);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (event.event == "phase") {
+            currentPhase = line;
+        } else if (event.event == "prompt") {
+            // Odpowiedzi sprzed pytania nie mogą rozstrzygnąć nowego
+            pendingPrompt = line;
+            clearAnswers();
+        } else if (event.event == "answer" || event.event == "result") {
+            pendingPrompt.clear();
+            clearAnswers();
+        }
+        for (auto& entry : clients) {
+            entry.second.output += line;
+        }
+    }
+    if (wakeFd >= 0) {
+        signalEvent(wakeFd);
+    }
+}
+
+std::string ProgressServer::takeAnswer() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (answers.empty()) {
+        return "";
+    }
+    // Pytanie rozstrzyga pierwsza odpowiedź; kolejne (np. z drugiego klienta) są odrzucane
+    std::string answer = answers.front();
+    clearAnswers();
+    return answer;
+}
+
+void ProgressServer::clearAnswers() {
+    answers.clear();
+    // eventfd w trybie semafora: każdy odczyt zdejmuje jedną odpowiedź
+    uint64_t value;
+    while (answerFd >= 0 && read(answerFd, &value, sizeof(value)) > 0) {
+    }
+}
+
+void ProgressServer::run() {
+    std::vector<pollfd> descriptors;
+    std::vector<char> buffer(4096);
+    
+    while (!stopping) {
+        descriptors.clear();
+        descriptors.push_back({listenFd, POLLIN, 0});
+        descriptors.push_back({wakeFd, POLLIN, 0});
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& entry : clients) {
+                short events = POLLIN;
+                if (!entry.second.output.empty()) {
+                    events |= POLLOUT;
+                }
+                descriptors.push_back({entry.first, events, 0});
+            }
+        }
+        
+        if (poll(descriptors.data(), descriptors.size(), -1) < 0 && errno != EINTR) {
+            break;
+        }
+        if (descriptors[1].revents & POLLIN) {
+            drainEvent(wakeFd);
+        }
+        
+        if (descriptors[0].revents & POLLIN) {
+            int client;
+            while ((client = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK)) >= 0) {
+                std::lock_guard<std::mutex> lock(mutex);
+                clients[client].output = currentPhase + pendingPrompt;
+            }
+        }
+        
+        std::vector<std::string> lines;
+        for (size_t i = 2; i < descriptors.size(); ++i) {
+            int fd = descriptors[i].fd;
+            bool closed = descriptors[i].revents & (POLLHUP | POLLERR);
+            
+            if (descriptors[i].revents & POLLIN) {
+                ssize_t size = read(fd, buffer.data(), buffer.size());
+                if (size > 0) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    std::string& input = clients[fd].input;
+                    input.append(buffer.data(), static_cast<size_t>(size));
+                    size_t newline;
+                    while ((newline = input.find('\n')) != std::string::npos) {
+                        lines.push_back(input.substr(0, newline));
+                        input.erase(0, newline + 1);
+                    }
+                    closed = closed || input.size() > 4096;
+                } else if (size == 0 || (errno != EAGAIN && errno != EINTR)) {
+                    closed = true;
+                }
+            }
+            
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = clients.find(fd);
+            if (!closed && it != clients.end()) {
+                closed = !flush(fd, it->second);
+            }
+            if (closed && it != clients.end()) {
+                close(fd);
+                clients.erase(it);
+            }
+        }
+        
+        // Polecenia poza blokadą: wywołanie zwrotne może publikować zdarzenia
+        for (const auto& line : lines) {
+            handleLine(line);
+        }
+    }
+}
+
+void ProgressServer::handleLine(const std::string& line) {
+    // Obiekt JSON lub samo słowo polecenia (wygodne z socat)
+    std::string command = jsonStringField(line, "command");
+    if (command.empty() && line.find('{') == std::string::npos) {
+        command = line;
+        while (!command.empty() && (command.back() == '\r' || command.back() == ' ')) {
+            command.pop_back();
+        }
+    }
+    if (command.empty()) {
+        return;
+    }
+    
+    if (command == "confirm" || command == "decline") {
+        std::lock_guard<std::mutex> lock(mutex);
+        // Odpowiedź bez zadanego pytania nie może czekać na następne (np. o restart)
+        if (pendingPrompt.empty()) {
+            return;
+        }
+        answers.push_back(command);
+        signalEvent(answerFd);
+    } else if (onCommand) {
+        onCommand(command);
+    }
+}
+
+bool ProgressServer::flush(int fd, Client& client) {
+    while (!client.output.empty()) {
+        ssize_t written = send(fd, client.output.data(), client.output.size(), MSG_NOSIGNAL);
+        if (written < 0) {
+            return errno == EAGAIN || errno == EINTR ? client.output.size() <= maxPendingOutput : false;
+        }
+        client.output.erase(0, static_cast<size_t>(written));
+    }
+    return true;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "install-progress.h"
+
+// Gniazdo Unix z postępem instalacji dla interfejsu graficznego. Zdarzenia trafiają do
+// wszystkich klientów jako linie JSON; klienci wysyłają polecenia, również jako linie JSON:
+// {"command":"confirm"}, {"command":"decline"} (odpowiedź na pytanie) i {"command":"cancel"}.
+// Nowy klient dostaje najpierw bieżący etap i oczekujące pytanie. Gniazdo obsługuje
+// osobny wątek; zbyt wolny klient jest rozłączany, żeby nie wstrzymywał instalacji.
+class ProgressServer {
+public:
+    using CommandCallback = std::function<void(const std::string& command)>;
+    
+    static constexpr const char* defaultPath = "/run/auto-driver-installer.sock";
+
+private:
+    struct Client {
+        std::string input;    // Niepełna linia polecenia
+        std::string output;   // Zdarzenia jeszcze niewysłane
+    };
+    
+    std::string path;
+    int listenFd = -1;
+    bool bound = false;                      // Plik gniazda utworzony przez ten obiekt
+    int wakeFd = -1;                         // eventfd budzący wątek po nowym zdarzeniu
+    int answerFd = -1;                       // eventfd: odpowiedź czeka w kolejce
+    std::thread worker;
+    std::atomic<bool> stopping{false};
+    CommandCallback onCommand;
+    
+    std::mutex mutex;
+    std::map<int, Client> clients;
+    std::string currentPhase;                // Ostatnie zdarzenie phase (dla nowych klientów)
+    std::string pendingPrompt;               // Pytanie bez odpowiedzi (dla nowych klientów)
+    std::deque<std::string> answers;         // confirm/decline w kolejności nadejścia
+
+public:
+    explicit ProgressServer(std::string path = defaultPath);
+    ~ProgressServer();
+    
+    ProgressServer(const ProgressServer&) = delete;
+    ProgressServer& operator=(const ProgressServer&) = delete;
+    
+    // Utworzenie gniazda i uruchomienie wątku; false, gdy gniazdo zajmuje inny działający instalator.
+    // onCommand dostaje polecenia inne niż odpowiedzi (np. cancel), w wątku gniazda.
+    bool start(CommandCallback onCommand);
+    void stop();
+    
+    // Wysłanie zdarzenia do wszystkich klientów (bezpieczne z każdego wątku)
+    void publish(const ProgressEvent& event);
+    
+    // Deskryptor do poll: POLLIN, gdy czeka odpowiedź z gniazda
+    int answerDescriptor() const { return answerFd; }
+    
+    // Najstarsza odpowiedź (confirm lub decline) na bieżące pytanie; pusta, jeśli jej nie ma.
+    // Odpowiedzi przyjmowane są tylko między zdarzeniami prompt i answer/result.
+    std::string takeAnswer();
+    
+    const std::string& socketPath() const { return path; }
+
+private:
+    void run();
+    void handleLine(const std::string& line);
+    void clearAnswers();                     // Wywoływane pod mutex
+    bool flush(int fd, Client& client);
+};
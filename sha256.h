@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Strumieniowe liczenie skrótu SHA-256 (adresowanie treścią w kopii zapasowej)
+class Sha256 {
+private:
+    uint32_t state[8];
+    uint8_t block[64];
+    size_t blockSize = 0;
+    uint64_t totalBytes = 0;
+
+public:
+    Sha256();
+    
+    void update(const void* data, size_t size);
+    
+    // Skrót w postaci 64 znaków szesnastkowych
+    std::string hexDigest();
+    
+    static std::string hash(const std::string& data);
+
+private:
+    void transform(const uint8_t* chunk);
+};
@@ -0,0 +1,343 @@
+#include "simulated-backend.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+CommandResult SimulatedCommandRunner::run(const std::vector<std::string>& argv, const OutputCallback& onOutput) {
+    CommandResult result;
+    if (argv.empty()) {
+        return result;
+    }
+    
+    std::chrono::milliseconds delay{0};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        calls.push_back(argv);
+        
+        auto latencyIt = latency.find(argv[0]);
+        if (latencyIt != latency.end()) {
+            delay = latencyIt->second;
+        }
+        auto outputIt = outputs.find(argv[0]);
+        if (outputIt != outputs.end()) {
+            result.output = outputIt->second;
+        }
+        result.exitCode = failingPrograms.count(argv[0]) ? 1 : 0;
+    }
+    
+    std::this_thread::sleep_for(delay);
+    result.duration = delay;
+    
+    // Wyjście przekazywane jest liniami, tak jak przy prawdziwym procesie
+    if (onOutput) {
+        size_t start = 0;
+        while (start < result.output.size()) {
+            size_t newline = result.output.find('\n', start);
+            size_t end = newline == std::string::npos ? result.output.size() : newline + 1;
+            onOutput(result.output.substr(start, end - start));
+            start = end;
+        }
+        result.output.clear();
+    }
+    return result;
+}
+
+void SimulatedCommandRunner::setLatency(const std::string& program, std::chrono::milliseconds duration) {
+    std::lock_guard<std::mutex> lock(mutex);
+    latency[program] = duration;
+}
+
+void SimulatedCommandRunner::setOutput(const std::string& program, const std::string& output) {
+    std::lock_guard<std::mutex> lock(mutex);
+    outputs[program] = output;
+}
+
+void SimulatedCommandRunner::setFailure(const std::string& program, bool failing) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (failing) {
+        failingPrograms.insert(program);
+    } else {
+        failingPrograms.erase(program);
+    }
+}
+
+std::vector<std::vector<std::string>> SimulatedCommandRunner::history() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return calls;
+}
+
+bool SimulatedPackageBackend::install(const std::vector<std::string>& packages) {
+    // Pakiety z lokalnego repozytorium nie są pobierane; bez sieci brakujących nie ma skąd wziąć
+    size_t downloads = 0;
+    for (const auto& package : packages) {
+        downloads += isCached(package) ? 0 : 1;
+    }
+    simulate("install", packages.size(), downloads);
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    if (failingOperations.count("install") || (localOnly && downloads > 0)) {
+        return false;
+    }
+    for (const auto& package : packages) {
+        if (failingPackages.count(package)) {
+            return false;
+        }
+    }
+    
+    std::set<std::string> before = installed;
+    for (const auto& package : packages) {
+        installed.insert(package);
+        
+        // Instalacja pakietu *-release z RPM Fusion włącza odpowiednie repozytorium
+        if (package.find("rpmfusion-free-release") != std::string::npos) {
+            enabledRepositories.insert("rpmfusion-free");
+        } else if (package.find("rpmfusion-nonfree-release") != std::string::npos) {
+            enabledRepositories.insert("rpmfusion-nonfree");
+        }
+    }
+    commitTransaction(before);
+    return true;
+}
+
+bool SimulatedPackageBackend::remove(const std::vector<std::string>& packages) {
+    simulate("remove", packages.size());
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    if (failingOperations.count("remove")) {
+        return false;
+    }
+    std::set<std::string> before = installed;
+    for (const auto& package : packages) {
+        // Wzorzec zakończony * usuwa wszystkie pakiety o danym prefiksie
+        if (!package.empty() && package.back() == '*') {
+            std::string prefix = package.substr(0, package.size() - 1);
+            for (auto it = installed.begin(); it != installed.end();) {
+                it = it->compare(0, prefix.size(), prefix) == 0 ? installed.erase(it) : std::next(it);
+            }
+        } else {
+            installed.erase(package);
+        }
+    }
+    commitTransaction(before);
+    return true;
+}
+
+bool SimulatedPackageBackend::reinstall(const std::vector<std::string>& packages) {
+    simulate("reinstall", packages.size());
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    if (failingOperations.count("reinstall")) {
+        return false;
+    }
+    commitTransaction(installed);
+    return true;
+}
+
+bool SimulatedPackageBackend::isRepositoryEnabled(const std::string& repositoryId) {
+    simulate("repolist", 0);
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& repository : enabledRepositories) {
+        if (repository.find(repositoryId) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string SimulatedPackageBackend::releaseVersion() {
+    simulate("release", 0);
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    return release;
+}
+
+std::string SimulatedPackageBackend::lastTransactionId() {
+    simulate("history", 0);
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    return history.empty() ? "" : std::to_string(history.rbegin()->first);
+}
+
+bool SimulatedPackageBackend::undoTransaction(const std::string& id) {
+    simulate("undo", 0);
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = history.find(std::atoi(id.c_str()));
+    if (failingOperations.count("undo") || it == history.end()) {
+        return false;
+    }
+    
+    // Odwrócenie tylko zmian tej transakcji, tak jak dnf history undo
+    std::set<std::string> before = installed;
+    for (const auto& package : it->second.installedAfter) {
+        if (!it->second.installedBefore.count(package)) {
+            installed.erase(package);
+        }
+    }
+    for (const auto& package : it->second.installedBefore) {
+        if (!it->second.installedAfter.count(package)) {
+            installed.insert(package);
+        }
+    }
+    commitTransaction(before);
+    return true;
+}
+
+bool SimulatedPackageBackend::rollbackTransactions(const std::string& firstId) {
+    simulate("rollback", 0);
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = history.find(std::atoi(firstId.c_str()));
+    if (failingOperations.count("rollback") || it == history.end()) {
+        return false;
+    }
+    
+    std::set<std::string> before = installed;
+    installed = it->second.installedBefore;
+    commitTransaction(before);
+    return true;
+}
+
+std::map<std::string, std::string> SimulatedPackageBackend::installedVersions(const std::vector<std::string>& packages) {
+    simulate("query", 0);
+    
+    // Wersja zależy tylko od wydania systemu
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<std::string, std::string> versions;
+    for (const auto& package : packages) {
+        if (installed.count(package)) {
+            versions[package] = "0:1.0-1.fc" + release + ".x86_64";
+        }
+    }
+    return versions;
+}
+
+bool SimulatedPackageBackend::download(const std::vector<std::string>& packages, const std::string& directory,
+                                       bool /*allDependencies*/, const CommandRunner::OutputCallback& onOutput) {
+    simulate("download", 0, packages.size());
+    
+    std::vector<std::string> lines;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (failingOperations.count("download")) {
+            return false;
+        }
+        
+        // Pliki zastępcze o nazwach jak z dnf download, żeby tryb offline działał na kolejnych przebiegach
+        std::error_code error;
+        fs::create_directories(directory, error);
+        for (size_t i = 0; i < packages.size(); ++i) {
+            std::string file = packageFileName(packages[i]);
+            std::ofstream(directory + "/" + file) << packages[i] << "\n";
+            lines.push_back("(" + std::to_string(i + 1) + "/" + std::to_string(packages.size()) + "): " + file +
+                            "  1.0 MB/s |  1.0 MB     00:01\n");
+        }
+        if (error) {
+            return false;
+        }
+    }
+    
+    // Linie zakończonych pobrań w formacie dnf4
+    if (onOutput) {
+        for (const auto& line : lines) {
+            onOutput(line);
+        }
+    }
+    return true;
+}
+
+bool SimulatedPackageBackend::createRepository(const std::string& directory) {
+    simulate("createrepo", 0);
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    std::error_code error;
+    fs::create_directories(directory + "/repodata", error);
+    std::ofstream metadata(directory + "/repodata/repomd.xml");
+    metadata << "<repomd/>\n";
+    return !failingOperations.count("createrepo") && metadata.good();
+}
+
+void SimulatedPackageBackend::useLocalRepository(const std::string& directory, bool exclusive) {
+    std::lock_guard<std::mutex> lock(mutex);
+    localRepository = directory;
+    localOnly = exclusive;
+}
+
+std::string SimulatedPackageBackend::packageFileName(const std::string& package) const {
+    return package + "-1.0-1.fc" + release + ".x86_64.rpm";
+}
+
+bool SimulatedPackageBackend::isCached(const std::string& package) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::error_code error;
+    if (package.find('/') != std::string::npos && package.find("://") == std::string::npos) {
+        return fs::exists(package, error);
+    }
+    return !localRepository.empty() && fs::exists(localRepository + "/" + packageFileName(package), error);
+}
+
+void SimulatedPackageBackend::setLatency(const std::string& operation, std::chrono::milliseconds duration) {
+    std::lock_guard<std::mutex> lock(mutex);
+    latency[operation] = duration;
+}
+
+void SimulatedPackageBackend::setPerPackageLatency(std::chrono::milliseconds duration) {
+    std::lock_guard<std::mutex> lock(mutex);
+    perPackageLatency = duration;
+}
+
+void SimulatedPackageBackend::setDownloadLatency(std::chrono::milliseconds duration) {
+    std::lock_guard<std::mutex> lock(mutex);
+    downloadLatency = duration;
+}
+
+void SimulatedPackageBackend::failOperation(const std::string& operation) {
+    std::lock_guard<std::mutex> lock(mutex);
+    failingOperations.insert(operation);
+}
+
+void SimulatedPackageBackend::failPackage(const std::string& package) {
+    std::lock_guard<std::mutex> lock(mutex);
+    failingPackages.insert(package);
+}
+
+void SimulatedPackageBackend::enableRepository(const std::string& repositoryId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    enabledRepositories.insert(repositoryId);
+}
+
+bool SimulatedPackageBackend::isInstalled(const std::string& package) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return installed.count(package) != 0;
+}
+
+int SimulatedPackageBackend::operationCount(const std::string& operation) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = operationCounts.find(operation);
+    return it == operationCounts.end() ? 0 : it->second;
+}
+
+void SimulatedPackageBackend::commitTransaction(const std::set<std::string>& installedBefore) {
+    int id = history.empty() ? 1 : history.rbegin()->first + 1;
+    history[id] = {installedBefore, installed};
+}
+
+void SimulatedPackageBackend::simulate(const std::string& operation, size_t packageCount, size_t downloadCount) {
+    std::chrono::milliseconds delay{0};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++operationCounts[operation];
+        auto it = latency.find(operation);
+        if (it != latency.end()) {
+            delay = it->second;
+        }
+        delay += perPackageLatency * static_cast<int>(packageCount);
+        delay += downloadLatency * static_cast<int>(downloadCount);
+    }
+    std::this_thread::sleep_for(delay);
+}
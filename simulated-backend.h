@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "command-runner.h"
+#include "package-backend.h"
+
+// Symulowane uruchamianie poleceń: opóźnienie i wynik zależą od nazwy programu,
+// nic nie jest wykonywane w systemie
+class SimulatedCommandRunner : public CommandRunner {
+private:
+    mutable std::mutex mutex;
+    std::map<std::string, std::chrono::milliseconds> latency;
+    std::map<std::string, std::string> outputs;
+    std::set<std::string> failingPrograms;
+    std::vector<std::vector<std::string>> calls;
+
+public:
+    CommandResult run(const std::vector<std::string>& argv, const OutputCallback& onOutput = nullptr) override;
+    
+    void setLatency(const std::string& program, std::chrono::milliseconds duration);
+    void setOutput(const std::string& program, const std::string& output);
+    void setFailure(const std::string& program, bool failing);
+    
+    // Wszystkie wywołania w kolejności uruchomienia
+    std::vector<std::vector<std::string>> history() const;
+};
+
+// Symulowany menedżer pakietów z modelem opóźnień i wstrzykiwaniem błędów
+class SimulatedPackageBackend : public PackageBackend {
+private:
+    // Stan pakietów przed i po transakcji z historii (do undo i rollback)
+    struct TransactionStates {
+        std::set<std::string> installedBefore;
+        std::set<std::string> installedAfter;
+    };
+    
+    mutable std::mutex mutex;
+    std::map<std::string, std::chrono::milliseconds> latency;  // Stały koszt operacji
+    std::chrono::milliseconds perPackageLatency{0};             // Koszt każdego pakietu w transakcji
+    std::chrono::milliseconds downloadLatency{0};               // Koszt pobrania pakietu spoza lokalnego repozytorium
+    std::set<std::string> failingOperations;
+    std::set<std::string> failingPackages;
+    std::set<std::string> installed;
+    std::set<std::string> enabledRepositories;
+    std::map<std::string, int> operationCounts;
+    std::map<int, TransactionStates> history;
+    std::string release = "40";
+    std::string localRepository;     // Katalog lokalnego repozytorium (pusty: brak)
+    bool localOnly = false;
+
+public:
+    bool install(const std::vector<std::string>& packages) override;
+    bool remove(const std::vector<std::string>& packages) override;
+    bool reinstall(const std::vector<std::string>& packages) override;
+    bool isRepositoryEnabled(const std::string& repositoryId) override;
+    std::string releaseVersion() override;
+    std::string lastTransactionId() override;
+    bool undoTransaction(const std::string& id) override;
+    bool rollbackTransactions(const std::string& firstId) override;
+    std::map<std::string, std::string> installedVersions(const std::vector<std::string>& packages) override;
+    bool download(const std::vector<std::string>& packages, const std::string& directory,
+                  bool allDependencies = false, const CommandRunner::OutputCallback& onOutput = nullptr) override;
+    bool createRepository(const std::string& directory) override;
+    void useLocalRepository(const std::string& directory, bool exclusive) override;
+    
+    // Operacje: install, remove, reinstall, repolist, release, history, undo, rollback, query,
+    // download, createrepo
+    void setLatency(const std::string& operation, std::chrono::milliseconds duration);
+    void setPerPackageLatency(std::chrono::milliseconds duration);
+    void setDownloadLatency(std::chrono::milliseconds duration);
+    
+    // Nazwa pliku RPM pakietu w repozytorium
+    std::string packageFileName(const std::string& package) const;
+    void failOperation(const std::string& operation);
+    void failPackage(const std::string& package);
+    void enableRepository(const std::string& repositoryId);
+    
+    bool isInstalled(const std::string& package) const;
+    int operationCount(const std::string& operation) const;
+
+private:
+    // Odczekanie kosztu operacji i zliczenie jej wywołania
+    void simulate(const std::string& operation, size_t packageCount, size_t downloadCount = 0);
+    
+    // Czy pakiet (nazwa lub ścieżka pliku) jest w lokalnym repozytorium
+    bool isCached(const std::string& package) const;
+    
+    // Zapisanie transakcji w historii (wywoływane pod blokadą, po zmianie stanu)
+    void commitTransaction(const std::set<std::string>& installedBefore);
+};
@@ -0,0 +1,135 @@
+#include "systemd-service.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+extern char** environ;
+
+namespace {
+
+// Stałe ioprio z linux/ioprio.h (glibc nie udostępnia opakowania ioprio_set)
+constexpr int IOPRIO_WHO_PROCESS = 1;
+constexpr int IOPRIO_CLASS_IDLE = 3;
+constexpr int IOPRIO_CLASS_SHIFT = 13;
+
+}
+
+SystemdNotifier::SystemdNotifier() {
+    const char* path = std::getenv("NOTIFY_SOCKET");
+    if (!path || (path[0] != '/' && path[0] != '@') || std::strlen(path) >= sizeof(sockaddr_un::sun_path)) {
+        return;
+    }
+    
+    fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return;
+    }
+    
+    // Adres zaczynający się od @ należy do abstrakcyjnej przestrzeni nazw
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    size_t length = std::strlen(path);
+    std::memcpy(address.sun_path, path, length);
+    if (path[0] == '@') {
+        address.sun_path[0] = '\0';
+    }
+    socklen_t size = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + length + (path[0] == '@' ? 0 : 1));
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), size) != 0) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+SystemdNotifier::~SystemdNotifier() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+bool SystemdNotifier::notify(const std::string& state) {
+    if (fd < 0) {
+        return false;
+    }
+    return send(fd, state.data(), state.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(state.size());
+}
+
+bool SystemdNotifier::ready(const std::string& status) {
+    return notify("READY=1\nSTATUS=" + status);
+}
+
+bool SystemdNotifier::status(const std::string& status) {
+    return notify("STATUS=" + status);
+}
+
+ShutdownInhibitor::ShutdownInhibitor(const std::string& who, const std::string& why) {
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) != 0) {
+        return;
+    }
+    
+    // Koniec do odczytu staje się standardowym wejściem cat uruchomionego przez systemd-inhibit
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[0], STDIN_FILENO);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    
+    std::string whoArg = "--who=" + who;
+    std::string whyArg = "--why=" + why;
+    std::vector<char*> argv = {const_cast<char*>("systemd-inhibit"), const_cast<char*>("--what=shutdown:sleep"),
+                               const_cast<char*>(whoArg.c_str()), const_cast<char*>(whyArg.c_str()),
+                               const_cast<char*>("--mode=block"), const_cast<char*>("cat"), nullptr};
+    // --daemon blokuje SIGTERM i SIGINT dla signalfd; systemd-inhibit nie może tej maski odziedziczyć
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    sigset_t emptyMask;
+    sigemptyset(&emptyMask);
+    posix_spawnattr_setsigmask(&attributes, &emptyMask);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGMASK);
+    
+    pid_t child = -1;
+    int error = posix_spawnp(&child, "systemd-inhibit", &actions, &attributes, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attributes);
+    close(fds[0]);
+    
+    if (error != 0) {
+        close(fds[1]);
+        return;
+    }
+    pid = child;
+    pipeFd = fds[1];
+}
+
+ShutdownInhibitor::~ShutdownInhibitor() {
+    release();
+}
+
+void ShutdownInhibitor::release() {
+    if (pipeFd >= 0) {
+        close(pipeFd);
+        pipeFd = -1;
+    }
+    if (pid > 0) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        pid = -1;
+    }
+}
+
+bool enterBackgroundPriority() {
+    bool ioIdle = syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT) == 0;
+    sched_param parameters = {};
+    bool cpuIdle = sched_setscheduler(0, SCHED_IDLE, &parameters) == 0;
+    return ioIdle && cpuIdle;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <sys/types.h>
+
+// Powiadomienia menedżera usług (protokół sd_notify) bez libsystemd: datagramy
+// "KLUCZ=wartość" na gniazdo z $NOTIFY_SOCKET. Poza systemd wszystkie wywołania nic nie robią.
+class SystemdNotifier {
+private:
+    int fd = -1;
+
+public:
+    SystemdNotifier();
+    ~SystemdNotifier();
+    
+    SystemdNotifier(const SystemdNotifier&) = delete;
+    SystemdNotifier& operator=(const SystemdNotifier&) = delete;
+    
+    // Czy program działa jako usługa z gniazdem powiadomień
+    bool enabled() const { return fd >= 0; }
+    
+    // Jedna lub więcej linii "KLUCZ=wartość"
+    bool notify(const std::string& state);
+    
+    bool ready(const std::string& status);
+    bool status(const std::string& status);
+};
+
+// Blokada wyłączenia i uśpienia systemu na czas zmian w pakietach. Utrzymuje ją proces
+// systemd-inhibit, którego potomek czyta potok; zamknięcie potoku (także przy awarii
+// instalatora) kończy go i zwalnia blokadę.
+class ShutdownInhibitor {
+private:
+    pid_t pid = -1;
+    int pipeFd = -1;
+
+public:
+    ShutdownInhibitor(const std::string& who, const std::string& why);
+    ~ShutdownInhibitor();
+    
+    ShutdownInhibitor(const ShutdownInhibitor&) = delete;
+    ShutdownInhibitor& operator=(const ShutdownInhibitor&) = delete;
+    
+    bool held() const { return pid > 0; }
+    void release();
+};
+
+// Najniższy priorytet wątku wywołującego oraz wątków i procesów, które później uruchomi
+// (dnf, akmods): klasa I/O idle i planista SCHED_IDLE, żeby instalacja w tle nie spowalniała startu sesji
+bool enterBackgroundPriority();
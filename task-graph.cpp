@@ -0,0 +1,116 @@
+#include "task-graph.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+void TaskGraph::addTask(const std::string& name, std::vector<std::string> dependencies, Task task) {
+    Node node;
+    node.name = name;
+    node.dependencies = std::move(dependencies);
+    node.task = std::move(task);
+    indexByName[name] = nodes.size();
+    nodes.push_back(std::move(node));
+}
+
+bool TaskGraph::run(size_t maxThreads) {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<size_t> ready;
+    size_t remaining = nodes.size();
+    
+    // Zbudowanie krawędzi; nieznana zależność oznacza, że zadanie nie może się wykonać
+    std::vector<bool> brokenDependency(nodes.size(), false);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        nodes[i].dependents.clear();
+        nodes[i].finished = false;
+        nodes[i].succeeded = false;
+    }
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        nodes[i].pendingDependencies = 0;
+        for (const auto& dependency : nodes[i].dependencies) {
+            auto it = indexByName.find(dependency);
+            if (it == indexByName.end()) {
+                brokenDependency[i] = true;
+                continue;
+            }
+            nodes[it->second].dependents.push_back(i);
+            ++nodes[i].pendingDependencies;
+        }
+    }
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].pendingDependencies == 0) {
+            ready.push_back(i);
+        }
+    }
+    
+    // Zakończenie zadania zwalnia zadania zależne (wywoływane pod blokadą)
+    std::function<void(size_t, bool)> complete = [&](size_t index, bool success) {
+        nodes[index].finished = true;
+        nodes[index].succeeded = success;
+        --remaining;
+        for (size_t dependent : nodes[index].dependents) {
+            if (!success) {
+                brokenDependency[dependent] = true;
+            }
+            if (--nodes[dependent].pendingDependencies == 0) {
+                ready.push_back(dependent);
+            }
+        }
+    };
+    
+    size_t running = 0;
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            changed.wait(lock, [&]() {
+                return !ready.empty() || remaining == 0 || running == 0;
+            });
+            if (ready.empty()) {
+                // Nic gotowego i nic w toku: koniec albo cykl zależności
+                break;
+            }
+            
+            size_t index = ready.front();
+            ready.pop_front();
+            
+            if (brokenDependency[index]) {
+                complete(index, false);
+                changed.notify_all();
+                continue;
+            }
+            
+            ++running;
+            lock.unlock();
+            bool success = nodes[index].task ? nodes[index].task() : true;
+            lock.lock();
+            --running;
+            
+            complete(index, success);
+            changed.notify_all();
+        }
+        changed.notify_all();
+    };
+    
+    size_t threadCount = std::max<size_t>(1, std::min(maxThreads, nodes.size()));
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    return std::all_of(nodes.begin(), nodes.end(), [](const Node& node) {
+        return node.finished && node.succeeded;
+    });
+}
+
+bool TaskGraph::succeeded(const std::string& name) const {
+    auto it = indexByName.find(name);
+    return it != indexByName.end() && nodes[it->second].finished && nodes[it->second].succeeded;
+}
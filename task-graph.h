@@ -0,0 +1,38 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// Wykonywanie faz z zadeklarowanymi zależnościami na ograniczonej puli wątków.
+// Zadania niezależne od siebie działają równolegle; zadanie, którego zależność
+// się nie powiodła, nie jest uruchamiane.
+class TaskGraph {
+public:
+    using Task = std::function<bool()>;
+
+private:
+    struct Node {
+        std::string name;
+        std::vector<std::string> dependencies;
+        Task task;
+        std::vector<size_t> dependents;
+        size_t pendingDependencies = 0;
+        bool finished = false;
+        bool succeeded = false;
+    };
+    
+    std::vector<Node> nodes;
+    std::map<std::string, size_t> indexByName;
+
+public:
+    // Dodanie zadania; zależności muszą zostać dodane wcześniej lub później przed run()
+    void addTask(const std::string& name, std::vector<std::string> dependencies, Task task);
+    
+    // Uruchomienie wszystkich zadań; true, jeśli każde zakończyło się powodzeniem
+    bool run(size_t maxThreads);
+    
+    // Wynik pojedynczego zadania po run()
+    bool succeeded(const std::string& name) const;
+};
@@ -0,0 +1,245 @@
+#include "trace.h"
+#include "file-utils.h"
+#include "json-utils.h"
+
+#include <cstdio>
+#include <sstream>
+#include <utility>
+
+// Dla getpid
+#include <unistd.h>
+
+namespace {
+
+std::string escapeLabel(const std::string& text) {
+    std::string result;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+        }
+        result += c == '\n' ? ' ' : c;
+    }
+    return result;
+}
+
+std::string seconds(int64_t micros) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.6f", static_cast<double>(micros) / 1e6);
+    return buffer;
+}
+
+}
+
+TraceRecorder::Span::Span(TraceRecorder* recorder, std::string name, std::string category)
+    : recorder(recorder), start(std::chrono::steady_clock::now()) {
+    event.name = std::move(name);
+    event.category = std::move(category);
+}
+
+TraceRecorder::Span::Span(Span&& other) noexcept
+    : recorder(other.recorder), event(std::move(other.event)), start(other.start) {
+    other.recorder = nullptr;
+}
+
+TraceRecorder::Span::~Span() {
+    if (recorder) {
+        recorder->record(std::move(event), start);
+    }
+}
+
+void TraceRecorder::Span::setArg(const std::string& key, const std::string& value) {
+    event.args[key] = value;
+}
+
+void TraceRecorder::Span::setSuccess(bool success) {
+    event.args["success"] = success ? "true" : "false";
+}
+
+TraceRecorder::TraceRecorder()
+    : origin(std::chrono::steady_clock::now()), wallOrigin(std::chrono::system_clock::now()) {
+}
+
+TraceRecorder::Span TraceRecorder::span(const std::string& name, const std::string& category) {
+    return Span(this, name, category);
+}
+
+void TraceRecorder::record(TraceEvent event, std::chrono::steady_clock::time_point start) {
+    auto end = std::chrono::steady_clock::now();
+    event.startMicros = std::chrono::duration_cast<std::chrono::microseconds>(start - origin).count();
+    event.durationMicros = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    auto inserted = threadIds.emplace(std::this_thread::get_id(), static_cast<int>(threadIds.size()) + 1);
+    event.threadId = inserted.first->second;
+    events.push_back(std::move(event));
+}
+
+std::vector<TraceEvent> TraceRecorder::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return events;
+}
+
+std::string TraceRecorder::chromeTraceJson() const {
+    std::vector<TraceEvent> recorded = snapshot();
+    auto wallStart = std::chrono::duration_cast<std::chrono::microseconds>(wallOrigin.time_since_epoch()).count();
+    
+    std::ostringstream json;
+    json << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"startTimeUnixMicros\":" << wallStart << "},\"traceEvents\":[";
+    for (size_t i = 0; i < recorded.size(); ++i) {
+        const auto& event = recorded[i];
+        json << (i ? "," : "") << "\n{\"name\":\"" << escapeJson(event.name) << "\",\"cat\":\"" << escapeJson(event.category)
+             << "\",\"ph\":\"X\",\"ts\":" << event.startMicros << ",\"dur\":" << event.durationMicros
+             << ",\"pid\":" << getpid() << ",\"tid\":" << event.threadId << ",\"args\":{";
+        bool first = true;
+        for (const auto& arg : event.args) {
+            json << (first ? "" : ",") << "\"" << escapeJson(arg.first) << "\":\"" << escapeJson(arg.second) << "\"";
+            first = false;
+        }
+        json << "}}";
+    }
+    json << "\n]}\n";
+    return json.str();
+}
+
+std::string TraceRecorder::prometheusText() const {
+    std::vector<TraceEvent> recorded = snapshot();
+    
+    // Polecenia są agregowane według programu, fazy raportowane pojedynczo
+    struct CommandTotals {
+        int runs = 0;
+        int failures = 0;
+        int64_t micros = 0;
+        unsigned long long outputBytes = 0;
+    };
+    std::map<std::string, CommandTotals> commands;
+    
+    // Faza powtórzona (np. konfiguracja dwóch kart NVIDIA) jest sumowana
+    struct PhaseTotals {
+        int64_t micros = 0;
+        bool reported = false;
+        bool success = true;
+    };
+    std::map<std::string, PhaseTotals> phases;
+    for (const auto& event : recorded) {
+        if (event.category == "command") {
+            auto& totals = commands[event.name];
+            ++totals.runs;
+            totals.micros += event.durationMicros;
+            auto exitCode = event.args.find("exit_code");
+            if (exitCode != event.args.end() && exitCode->second != "0") {
+                ++totals.failures;
+            }
+            auto bytes = event.args.find("output_bytes");
+            if (bytes != event.args.end()) {
+                totals.outputBytes += std::stoull(bytes->second);
+            }
+        } else {
+            auto& totals = phases[event.name];
+            totals.micros += event.durationMicros;
+            auto success = event.args.find("success");
+            if (success != event.args.end()) {
+                totals.reported = true;
+                totals.success = totals.success && success->second == "true";
+            }
+        }
+    }
+    
+    std::ostringstream text;
+    text << "# HELP driver_installer_phase_duration_seconds Wall time of each installer phase in the last run.\n";
+    text << "# TYPE driver_installer_phase_duration_seconds gauge\n";
+    for (const auto& phase : phases) {
+        text << "driver_installer_phase_duration_seconds{phase=\"" << escapeLabel(phase.first) << "\"} "
+             << seconds(phase.second.micros) << "\n";
+    }
+    
+    text << "# HELP driver_installer_phase_success Whether the phase succeeded in the last run (1) or failed (0).\n";
+    text << "# TYPE driver_installer_phase_success gauge\n";
+    for (const auto& phase : phases) {
+        if (phase.second.reported) {
+            text << "driver_installer_phase_success{phase=\"" << escapeLabel(phase.first) << "\"} "
+                 << (phase.second.success ? 1 : 0) << "\n";
+        }
+    }
+    
+    text << "# HELP driver_installer_command_duration_seconds Total wall time of external commands in the last run.\n";
+    text << "# TYPE driver_installer_command_duration_seconds gauge\n";
+    for (const auto& command : commands) {
+        text << "driver_installer_command_duration_seconds{command=\"" << escapeLabel(command.first) << "\"} "
+             << seconds(command.second.micros) << "\n";
+    }
+    
+    text << "# HELP driver_installer_command_runs Number of external command runs in the last run.\n";
+    text << "# TYPE driver_installer_command_runs gauge\n";
+    for (const auto& command : commands) {
+        text << "driver_installer_command_runs{command=\"" << escapeLabel(command.first) << "\"} "
+             << command.second.runs << "\n";
+    }
+    
+    text << "# HELP driver_installer_command_failures Number of external commands that exited non-zero in the last run.\n";
+    text << "# TYPE driver_installer_command_failures gauge\n";
+    for (const auto& command : commands) {
+        text << "driver_installer_command_failures{command=\"" << escapeLabel(command.first) << "\"} "
+             << command.second.failures << "\n";
+    }
+    
+    text << "# HELP driver_installer_command_output_bytes Bytes of output produced by external commands in the last run.\n";
+    text << "# TYPE driver_installer_command_output_bytes gauge\n";
+    for (const auto& command : commands) {
+        text << "driver_installer_command_output_bytes{command=\"" << escapeLabel(command.first) << "\"} "
+             << command.second.outputBytes << "\n";
+    }
+    
+    text << "# HELP driver_installer_last_run_timestamp_seconds Unix time at which the last run started.\n";
+    text << "# TYPE driver_installer_last_run_timestamp_seconds gauge\n";
+    text << "driver_installer_last_run_timestamp_seconds "
+         << std::chrono::duration_cast<std::chrono::seconds>(wallOrigin.time_since_epoch()).count() << "\n";
+    
+    return text.str();
+}
+
+bool TraceRecorder::writeChromeTrace(const std::string& path) const {
+    return writeFileAtomically(path, chromeTraceJson());
+}
+
+bool TraceRecorder::writePrometheus(const std::string& path) const {
+    // Kolektor textfile odczytuje tylko *.prom, a plik musi pojawić się w całości
+    return writeFileAtomically(path, prometheusText());
+}
+
+TracingCommandRunner::TracingCommandRunner(std::shared_ptr<CommandRunner> inner, std::shared_ptr<TraceRecorder> recorder)
+    : inner(std::move(inner)), recorder(std::move(recorder)) {
+}
+
+CommandResult TracingCommandRunner::run(const std::vector<std::string>& argv, const OutputCallback& onOutput) {
+    auto span = recorder->span(argv.empty() ? "" : argv[0], "command");
+    
+    std::string commandLine;
+    for (const auto& arg : argv) {
+        commandLine += (commandLine.empty() ? "" : " ") + arg;
+    }
+    span.setArg("argv", commandLine);
+    
+    // Wyjście przekazywane do onOutput nie trafia do wyniku (dnf install, download), więc jest liczone tutaj
+    size_t streamedBytes = 0;
+    OutputCallback counting;
+    if (onOutput) {
+        counting = [&onOutput, &streamedBytes](const std::string& line) {
+            streamedBytes += line.size();
+            onOutput(line);
+        };
+    }
+    
+    CommandResult result = inner->run(argv, counting);
+    span.setArg("exit_code", std::to_string(result.exitCode));
+    span.setArg("output_bytes", std::to_string(streamedBytes + result.output.size() + result.errorOutput.size()));
+    if (result.signal != 0) {
+        span.setArg("signal", std::to_string(result.signal));
+    }
+    if (result.timedOut) {
+        span.setArg("timed_out", "true");
+    }
+    if (result.cancelled) {
+        span.setArg("cancelled", "true");
+    }
+    return result;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "command-runner.h"
+
+// Zakończony odcinek czasu (faza instalatora lub polecenie zewnętrzne)
+struct TraceEvent {
+    std::string name;                         // Nazwa fazy lub programu
+    std::string category;                     // "phase" lub "command"
+    int64_t startMicros = 0;                  // Początek względem startu nagrywania
+    int64_t durationMicros = 0;
+    int threadId = 0;                         // Numer wątku nadany przez rejestrator
+    std::map<std::string, std::string> args;  // Dodatkowe dane (kod wyjścia, rozmiar wyjścia, wynik)
+};
+
+// Rejestrator odcinków czasu z eksportem do formatu Chrome trace i pliku .prom
+class TraceRecorder {
+public:
+    // Odcinek mierzony od utworzenia do zniszczenia obiektu
+    class Span {
+    private:
+        TraceRecorder* recorder;
+        TraceEvent event;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        Span(TraceRecorder* recorder, std::string name, std::string category);
+        Span(Span&& other) noexcept;
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+        ~Span();
+        
+        void setArg(const std::string& key, const std::string& value);
+        void setSuccess(bool success);
+    };
+
+private:
+    mutable std::mutex mutex;
+    std::vector<TraceEvent> events;
+    std::map<std::thread::id, int> threadIds;
+    std::chrono::steady_clock::time_point origin;
+    std::chrono::system_clock::time_point wallOrigin;
+
+public:
+    TraceRecorder();
+    
+    Span span(const std::string& name, const std::string& category = "phase");
+    void record(TraceEvent event, std::chrono::steady_clock::time_point start);
+    
+    std::vector<TraceEvent> snapshot() const;
+    
+    // Plik JSON do otwarcia w chrome://tracing lub Perfetto
+    std::string chromeTraceJson() const;
+    
+    // Metryki w formacie tekstowym dla kolektora textfile node_exportera
+    std::string prometheusText() const;
+    
+    bool writeChromeTrace(const std::string& path) const;
+    bool writePrometheus(const std::string& path) const;
+};
+
+// Dekorator rejestrujący każde polecenie (czas, kod wyjścia, bajty wyjścia)
+class TracingCommandRunner : public CommandRunner {
+private:
+    std::shared_ptr<CommandRunner> inner;
+    std::shared_ptr<TraceRecorder> recorder;
+
+public:
+    TracingCommandRunner(std::shared_ptr<CommandRunner> inner, std::shared_ptr<TraceRecorder> recorder);
+    
+    CommandResult run(const std::vector<std::string>& argv, const OutputCallback& onOutput = nullptr) override;
+};
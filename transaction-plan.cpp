@@ -0,0 +1,23 @@
+#include "transaction-plan.h"
+
+void TransactionPlan::addDevice(const std::string& device, const std::vector<std::string>& packages) {
+    devices.push_back({device, packages});
+    requestedCount += packages.size();
+    
+    for (const auto& package : packages) {
+        if (seenPackages.insert(package).second) {
+            uniquePackages.push_back(package);
+        }
+    }
+}
+
+std::string TransactionPlan::join(const std::vector<std::string>& packages) {
+    std::string result;
+    for (const auto& package : packages) {
+        if (!result.empty()) {
+            result += ' ';
+        }
+        result += package;
+    }
+    return result;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <set>
+#include <string>
+#include <vector>
+
+// Plan jednej transakcji menedżera pakietów dla wszystkich wykrytych urządzeń
+class TransactionPlan {
+public:
+    // Pakiety wymagane przez pojedyncze urządzenie
+    struct DeviceEntry {
+        std::string device;                 // Opis urządzenia do logów
+        std::vector<std::string> packages;  // Pakiety w kolejności podanej przez instalator
+    };
+
+private:
+    std::vector<DeviceEntry> devices;
+    std::vector<std::string> uniquePackages;
+    std::set<std::string> seenPackages;
+    size_t requestedCount = 0;
+
+public:
+    // Dodanie pakietów urządzenia (duplikaty są pomijane w zbiorczej transakcji)
+    void addDevice(const std::string& device, const std::vector<std::string>& packages);
+    
+    // Pakiety bez powtórzeń, w kolejności pierwszego wystąpienia
+    const std::vector<std::string>& packages() const {
+        return uniquePackages;
+    }
+    
+    const std::vector<DeviceEntry>& deviceEntries() const {
+        return devices;
+    }
+    
+    // Liczba pakietów pominiętych, bo wymagało ich kilka urządzeń
+    size_t duplicateCount() const {
+        return requestedCount - uniquePackages.size();
+    }
+    
+    bool empty() const {
+        return uniquePackages.empty();
+    }
+    
+    // Połączenie nazw pakietów w jeden argument wiersza poleceń
+    static std::string join(const std::vector<std::string>& packages);
+};
@@ -0,0 +1,165 @@
+#include "uevent-monitor.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+// Dla gniazda netlink i poll
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+std::string Uevent::property(const std::string& key) const {
+    auto it = properties.find(key);
+    return it == properties.end() ? "" : it->second;
+}
+
+bool Uevent::isDisplayController() const {
+    // PCI_CLASS to szesnastkowy kod klasy bez zer wiodących (np. 30000 dla VGA)
+    std::string classCode = property("PCI_CLASS");
+    if (property("SUBSYSTEM") != "pci" || classCode.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    unsigned long value = std::strtoul(classCode.c_str(), &end, 16);
+    return end && *end == '\0' && (value >> 16) == 0x03;
+}
+
+UeventMonitor::~UeventMonitor() {
+    if (socketFd >= 0) {
+        close(socketFd);
+    }
+}
+
+bool UeventMonitor::open() {
+    socketFd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+    if (socketFd < 0) {
+        return false;
+    }
+    
+    // Serie zdarzeń przy podłączaniu stacji dokującej nie mogą przepełnić bufora
+    int bufferSize = 1024 * 1024;
+    if (setsockopt(socketFd, SOL_SOCKET, SO_RCVBUFFORCE, &bufferSize, sizeof(bufferSize)) != 0) {
+        setsockopt(socketFd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+    }
+    
+    // Grupa 1: zdarzenia wysyłane bezpośrednio przez jądro
+    sockaddr_nl address = {};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = 1;
+    if (bind(socketFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(socketFd);
+        socketFd = -1;
+        return false;
+    }
+    return true;
+}
+
+bool UeventMonitor::parse(const char* data, size_t size, Uevent& event) {
+    // Nagłówek "akcja@ścieżka", potem pola rozdzielone znakami NUL
+    size_t headerEnd = strnlen(data, size);
+    std::string header(data, headerEnd);
+    size_t at = header.find('@');
+    if (at == std::string::npos) {
+        return false;
+    }
+    event.action = header.substr(0, at);
+    event.devpath = header.substr(at + 1);
+    event.properties.clear();
+    
+    for (size_t offset = headerEnd + 1; offset < size;) {
+        size_t length = strnlen(data + offset, size - offset);
+        std::string field(data + offset, length);
+        size_t equals = field.find('=');
+        if (equals != std::string::npos) {
+            event.properties[field.substr(0, equals)] = field.substr(equals + 1);
+        }
+        offset += length + 1;
+    }
+    return true;
+}
+
+bool UeventMonitor::drain(std::vector<std::string>& slots) {
+    char buffer[8192];
+    while (true) {
+        sockaddr_nl sender = {};
+        iovec vector = {buffer, sizeof(buffer)};
+        msghdr message = {};
+        message.msg_name = &sender;
+        message.msg_namelen = sizeof(sender);
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        
+        ssize_t received = recvmsg(socketFd, &message, 0);
+        if (received < 0) {
+            // ENOBUFS: część zdarzeń przepadła, ale kolejny przebieg i tak porówna stan sysfs
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ENOBUFS;
+        }
+        
+        // Tylko komunikaty od jądra (nadawca 0), nie od innych procesów
+        Uevent event;
+        if (sender.nl_pid != 0 || !parse(buffer, static_cast<size_t>(received), event)) {
+            continue;
+        }
+        std::string slot = event.property("PCI_SLOT_NAME");
+        if (event.action == "add" && event.isDisplayController() && !slot.empty() &&
+            std::find(slots.begin(), slots.end(), slot) == slots.end()) {
+            slots.push_back(slot);
+        }
+    }
+}
+
+UeventWaitResult UeventMonitor::waitForDisplayDevices(std::chrono::milliseconds quiet,
+                                                      std::chrono::milliseconds maxDelay,
+                                                      std::chrono::milliseconds idle, int stopFd,
+                                                      std::vector<std::string>& slots) {
+    using Clock = std::chrono::steady_clock;
+    slots.clear();
+    if (socketFd < 0) {
+        return UeventWaitResult::FAILED;
+    }
+    
+    const auto started = Clock::now();
+    Clock::time_point firstEvent;
+    Clock::time_point lastEvent;
+    
+    while (true) {
+        // Przed pierwszym zdarzeniem czeka do końca czasu bezczynności, potem do ciszy lub maxDelay
+        int timeout = -1;
+        auto now = Clock::now();
+        if (!slots.empty()) {
+            auto until = std::min(lastEvent + quiet, firstEvent + maxDelay);
+            if (now >= until) {
+                return UeventWaitResult::DEVICES;
+            }
+            timeout = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(until - now).count()) + 1;
+        } else if (idle.count() > 0) {
+            if (now >= started + idle) {
+                return UeventWaitResult::IDLE;
+            }
+            timeout = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(started + idle - now).count()) + 1;
+        }
+        
+        pollfd descriptors[2] = {{socketFd, POLLIN, 0}, {stopFd, POLLIN, 0}};
+        int ready = poll(descriptors, stopFd >= 0 ? 2 : 1, timeout);
+        if (ready < 0 && errno != EINTR) {
+            return UeventWaitResult::FAILED;
+        }
+        if (ready > 0 && stopFd >= 0 && (descriptors[1].revents & POLLIN)) {
+            return UeventWaitResult::STOPPED;
+        }
+        if (ready > 0 && (descriptors[0].revents & POLLIN)) {
+            size_t before = slots.size();
+            if (!drain(slots)) {
+                return UeventWaitResult::FAILED;
+            }
+            if (slots.size() != before) {
+                lastEvent = Clock::now();
+                if (before == 0) {
+                    firstEvent = lastEvent;
+                }
+            }
+        }
+    }
+}
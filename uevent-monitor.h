@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+// Zdarzenie jądra (uevent) z gniazda NETLINK_KOBJECT_UEVENT
+struct Uevent {
+    std::string action;                             // add, remove, bind, change...
+    std::string devpath;                            // Ścieżka urządzenia w /sys
+    std::map<std::string, std::string> properties;  // KLUCZ=wartość (SUBSYSTEM, PCI_CLASS, PCI_SLOT_NAME...)
+    
+    std::string property(const std::string& key) const;
+    
+    // Urządzenie PCI klasy 0x03 (VGA, 3D, inny kontroler wyświetlania)
+    bool isDisplayController() const;
+};
+
+// Wynik oczekiwania na zdarzenia
+enum class UeventWaitResult {
+    DEVICES,  // Pojawiły się nowe kontrolery wyświetlania
+    IDLE,     // Upłynął czas bezczynności bez zdarzeń
+    STOPPED,  // Deskryptor zatrzymania (np. signalfd) jest gotowy do odczytu
+    FAILED    // Błąd gniazda
+};
+
+// Nasłuch zdarzeń jądra o urządzeniach PCI bez libudev
+class UeventMonitor {
+private:
+    int socketFd = -1;
+
+public:
+    UeventMonitor() = default;
+    ~UeventMonitor();
+    
+    UeventMonitor(const UeventMonitor&) = delete;
+    UeventMonitor& operator=(const UeventMonitor&) = delete;
+    
+    // Subskrypcja grupy zdarzeń jądra
+    bool open();
+    
+    // Oczekiwanie na dodanie kontrolerów wyświetlania. Seria zdarzeń (np. stacja dokująca
+    // z kilkoma urządzeniami) kończy się po quiet bez kolejnych zdarzeń, najpóźniej po maxDelay
+    // od pierwszego. idle równe zero oznacza oczekiwanie bez limitu; stopFd < 0 jest pomijany.
+    UeventWaitResult waitForDisplayDevices(std::chrono::milliseconds quiet, std::chrono::milliseconds maxDelay,
+                                           std::chrono::milliseconds idle, int stopFd,
+                                           std::vector<std::string>& slots);
+    
+    // Parsowanie komunikatu "akcja@ścieżka\0KLUCZ=wartość\0..."
+    static bool parse(const char* data, size_t size, Uevent& event);
+
+private:
+    // Odczyt wszystkich oczekujących komunikatów; adresy nowych kontrolerów trafiają do slots
+    bool drain(std::vector<std::string>& slots);
+};
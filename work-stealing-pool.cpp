@@ -0,0 +1,74 @@
+#include "work-stealing-pool.h"
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct WorkQueue {
+    std::mutex mutex;
+    std::deque<size_t> tasks;
+};
+
+}
+
+WorkStealingPool::WorkStealingPool(size_t threads) : threadCount(std::max<size_t>(1, threads)) {
+}
+
+void WorkStealingPool::parallelFor(size_t count, const std::function<void(size_t)>& task) {
+    size_t workers = std::max<size_t>(1, std::min(threadCount, count));
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    for (size_t i = 0; i < workers; ++i) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    
+    // Ciągłe zakresy: sąsiednie zadania jednego wątku zwykle dotyczą sąsiednich plików
+    for (size_t i = 0; i < count; ++i) {
+        queues[i * workers / count]->tasks.push_back(i);
+    }
+    
+    auto worker = [&](size_t self) {
+        while (true) {
+            size_t index = 0;
+            bool found = false;
+            {
+                std::lock_guard<std::mutex> lock(queues[self]->mutex);
+                if (!queues[self]->tasks.empty()) {
+                    index = queues[self]->tasks.back();
+                    queues[self]->tasks.pop_back();
+                    found = true;
+                }
+            }
+            
+            // Własna kolejka pusta: kradzież z początku kolejki innego wątku
+            for (size_t offset = 1; !found && offset < workers; ++offset) {
+                WorkQueue& victim = *queues[(self + offset) % workers];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.tasks.empty()) {
+                    index = victim.tasks.front();
+                    victim.tasks.pop_front();
+                    found = true;
+                }
+            }
+            
+            // Zadania nie tworzą nowych zadań, więc puste wszystkie kolejki oznaczają koniec
+            if (!found) {
+                return;
+            }
+            task(index);
+        }
+    };
+    
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < workers; ++i) {
+        threads.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
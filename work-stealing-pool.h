@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// Równoległe wykonanie wielu niezależnych zadań: każdy wątek dostaje własną kolejkę
+// z ciągłym zakresem indeksów i bierze zadania z jej końca, a gdy ją opróżni, podkrada
+// zadania z początku kolejek innych wątków. Nierówny koszt zadań (np. drzewa sysfs
+// różnej wielkości) nie zostawia wtedy bezczynnych wątków.
+class WorkStealingPool {
+private:
+    size_t threadCount;
+
+public:
+    explicit WorkStealingPool(size_t threads);
+    
+    // Wywołanie task(i) dla każdego i z [0, count); powrót po wykonaniu wszystkich
+    void parallelFor(size_t count, const std::function<void(size_t)>& task);
+    
+    size_t threads() const {
+        return threadCount;
+    }
+};